@@ -0,0 +1,37 @@
+#!/bin/bash
+# Generates synthetic test clips for the VlcMedia.Benchmark console command.
+#
+# Usage: GenerateBenchmarkClips.sh [OutputDir] [Seconds]
+#
+# Requires ffmpeg (i.e. 'sudo apt install ffmpeg'). The clips are generated
+# locally from ffmpeg's test sources, so no media files need to be downloaded.
+
+outputDir=${1:-./Saved/VlcMediaBenchmark}
+duration=${2:-20}
+
+if ! command -v ffmpeg > /dev/null; then
+  printf "ffmpeg not found.\nInstall it with 'sudo apt install ffmpeg'\n"
+  exit 1
+fi
+
+mkdir -p $outputDir
+
+for size in 640x360 1280x720 1920x1080 3840x2160; do
+  # H.264 + AAC in MP4
+  ffmpeg -y -loglevel error \
+    -f lavfi -i testsrc2=size=$size:rate=30:duration=$duration \
+    -f lavfi -i sine=frequency=1000:sample_rate=48000:duration=$duration \
+    -c:v libx264 -preset veryfast -pix_fmt yuv420p -g 60 \
+    -c:a aac -b:a 128k \
+    $outputDir/h264-$size.mp4
+
+  # MPEG-2 + MP2 in MPEG-TS
+  ffmpeg -y -loglevel error \
+    -f lavfi -i testsrc2=size=$size:rate=30:duration=$duration \
+    -f lavfi -i sine=frequency=1000:sample_rate=48000:duration=$duration \
+    -c:v mpeg2video -q:v 4 -g 15 \
+    -c:a mp2 -b:a 192k \
+    $outputDir/mpeg2-$size.ts
+done
+
+printf "Generated benchmark clips in $outputDir\n"
@@ -0,0 +1,435 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaBenchmark.h"
+#include "VlcMediaPrivate.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "IMediaAudioSample.h"
+#include "IMediaModule.h"
+#include "IMediaPlayerFactory.h"
+#include "IMediaSamples.h"
+#include "IMediaTextureSample.h"
+#include "IMediaTracks.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Templates/UniquePtr.h"
+
+#if PLATFORM_WINDOWS
+	#include "Windows/WindowsHWrapper.h"
+#else
+	#include <sys/resource.h>
+#endif
+
+#include "VlcMediaPlayer.h"
+
+
+namespace VlcMediaBenchmark
+{
+	/** Fraction of the paced frame rate above which a file counts as rate-limited. */
+	const double RateLimitThreshold = 0.9;
+
+	/** Size of the buffer that files are warmed up with (in bytes). */
+	const int64 WarmUpBufferSize = 1024 * 1024;
+
+	/**
+	 * Get the CPU time that the process has used so far.
+	 *
+	 * @return User and kernel time of all threads (in seconds).
+	 */
+	double GetProcessCpuTime()
+	{
+#if PLATFORM_WINDOWS
+		FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+
+		if (!::GetProcessTimes(::GetCurrentProcess(), &CreationTime, &ExitTime, &KernelTime, &UserTime))
+		{
+			return 0.0;
+		}
+
+		// file times are in 100 nanosecond units
+		const uint64 Kernel = ((uint64)KernelTime.dwHighDateTime << 32) | KernelTime.dwLowDateTime;
+		const uint64 User = ((uint64)UserTime.dwHighDateTime << 32) | UserTime.dwLowDateTime;
+
+		return (Kernel + User) * 1e-7;
+#else
+		struct rusage Usage;
+
+		if (getrusage(RUSAGE_SELF, &Usage) != 0)
+		{
+			return 0.0;
+		}
+
+		return (Usage.ru_utime.tv_sec + Usage.ru_stime.tv_sec) + (Usage.ru_utime.tv_usec + Usage.ru_stime.tv_usec) * 1e-6;
+#endif
+	}
+}
+
+
+/* FVlcMediaBenchmark structors
+ *****************************************************************************/
+
+FVlcMediaBenchmark::FVlcMediaBenchmark(FLibvlcInstance* InVlcInstance, const TArray<FString>& InFiles, float InRate, const FString& InReportPath, bool InExitWhenDone, bool InCompareAccess)
+	: CurrentStartCpuTime(0.0)
+	, CurrentStartTime(0.0)
+	, EndReached(false)
+	, ExitWhenDone(InExitWhenDone)
+	, FileIndex(INDEX_NONE)
+	, Files(InFiles)
+	, Rate(InRate)
+	, ReportPath(InReportPath)
+	, RunsPerFile(InCompareAccess ? 2 : 1)
+	, VlcInstance(InVlcInstance)
+{ }
+
+
+FVlcMediaBenchmark::~FVlcMediaBenchmark()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	Player.Reset();
+}
+
+
+/* FVlcMediaBenchmark interface
+ *****************************************************************************/
+
+void FVlcMediaBenchmark::Start()
+{
+	UE_LOG(LogVlcMedia, Log, TEXT("Benchmark: Playing %i files at rate %.1f%s"), Files.Num(), Rate, (RunsPerFile > 1) ? TEXT(", comparing file access") : TEXT(""));
+
+	Player = MakeShared<FVlcMediaPlayer, ESPMode::ThreadSafe>(*this, VlcInstance, nullptr, nullptr);
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FVlcMediaBenchmark::HandleTicker));
+
+	OpenNextFile();
+}
+
+
+/* IMediaEventSink interface
+ *****************************************************************************/
+
+void FVlcMediaBenchmark::ReceiveMediaEvent(EMediaEvent Event)
+{
+	if (Event == EMediaEvent::PlaybackEndReached)
+	{
+		EndReached = true;
+	}
+}
+
+
+/* FVlcMediaBenchmark static functions
+ *****************************************************************************/
+
+void FVlcMediaBenchmark::ParseArgs(const TArray<FString>& Args, TArray<FString>& OutFiles, float& OutRate, FString& OutReportPath, bool& OutExitWhenDone, bool& OutCompareAccess)
+{
+	IMediaModule* MediaModule = FModuleManager::LoadModulePtr<IMediaModule>("Media");
+	IMediaPlayerFactory* Factory = (MediaModule != nullptr) ? MediaModule->GetPlayerFactory(TEXT("VlcMedia")) : nullptr;
+
+	for (const FString& Arg : Args)
+	{
+		if (Arg.StartsWith(TEXT("-rate=")))
+		{
+			OutRate = FCString::Atof(*Arg.Mid(6));
+		}
+		else if (Arg.StartsWith(TEXT("-report=")))
+		{
+			OutReportPath = Arg.Mid(8);
+		}
+		else if (Arg == TEXT("-compareaccess"))
+		{
+			OutCompareAccess = true;
+		}
+		else if (Arg == TEXT("-exit"))
+		{
+			OutExitWhenDone = true;
+		}
+		else if (IFileManager::Get().DirectoryExists(*Arg))
+		{
+			TArray<FString> FoundFiles;
+			IFileManager::Get().FindFiles(FoundFiles, *Arg, nullptr);
+			FoundFiles.Sort();
+
+			for (const FString& FoundFile : FoundFiles)
+			{
+				const FString FilePath = FPaths::Combine(Arg, FoundFile);
+
+				// skip subtitles, playlists, reports and other files that aren't media
+				if ((Factory != nullptr) && !Factory->CanPlayUrl(FString(TEXT("file://")) + FilePath, nullptr, nullptr, nullptr))
+				{
+					UE_LOG(LogVlcMedia, Verbose, TEXT("Benchmark: Skipping unsupported file %s"), *FilePath);
+					continue;
+				}
+
+				OutFiles.Add(FilePath);
+			}
+		}
+		else
+		{
+			OutFiles.Add(Arg);
+		}
+	}
+}
+
+
+/* FVlcMediaBenchmark implementation
+ *****************************************************************************/
+
+void FVlcMediaBenchmark::FinishFile()
+{
+	const FVlcMediaPlayerStats& Stats = Player->GetPlayerStats();
+
+	Current.BytesRead = Stats.InputBytesRead;
+	Current.Completed = EndReached;
+	Current.DecodedFrames = Stats.DecodedVideo;
+	Current.DroppedFrames = Stats.LostPictures;
+	Current.CpuSeconds = VlcMediaBenchmark::GetProcessCpuTime() - CurrentStartCpuTime;
+	Current.NativeAccess = Player->IsNativeFileAccess();
+	Current.WallSeconds = FPlatformTime::Seconds() - CurrentStartTime;
+
+	FMediaVideoTrackFormat Format;
+
+	if (Player->GetTracks().GetVideoTrackFormat(0, 0, Format))
+	{
+		Current.Dim = Format.Dim;
+		Current.FrameRate = Format.FrameRate;
+	}
+
+	const double PacedFps = Current.FrameRate * Rate;
+	Current.RateLimited = (PacedFps > 0.0) && (Current.WallSeconds > 0.0) && (Current.DecodedFrames / Current.WallSeconds >= VlcMediaBenchmark::RateLimitThreshold * PacedFps);
+
+	Results.Add(Current);
+	Player->Close();
+
+	UE_LOG(LogVlcMedia, Log, TEXT("Benchmark: %s (%s): %i frames in %.2fs (%.1f fps, %i dropped, %.1f MB/s read)%s"),
+		*Current.File,
+		Current.NativeAccess ? TEXT("path") : TEXT("archive"),
+		Current.DecodedFrames,
+		Current.WallSeconds,
+		(Current.WallSeconds > 0.0) ? Current.DecodedFrames / Current.WallSeconds : 0.0,
+		Current.DroppedFrames,
+		(Current.WallSeconds > 0.0) ? Current.BytesRead / (1024.0 * 1024.0 * Current.WallSeconds) : 0.0,
+		Current.Completed ? (Current.RateLimited ? TEXT(" [rate-limited]") : TEXT("")) : TEXT(" [timed out]")
+	);
+}
+
+
+bool FVlcMediaBenchmark::HandleTicker(float DeltaTime)
+{
+	if (IsDone() || !Player.IsValid())
+	{
+		return true;
+	}
+
+	Player->TickInput(FTimespan::FromSeconds(DeltaTime), FTimespan::MinValue());
+
+	// null sink: discard all samples
+	IMediaSamples& Samples = Player->GetSamples();
+	const TRange<FTimespan> AllTime(FTimespan::MinValue(), FTimespan::MaxValue());
+
+	TSharedPtr<IMediaTextureSample, ESPMode::ThreadSafe> VideoSample;
+
+	while (Samples.FetchVideo(AllTime, VideoSample))
+	{
+		++Current.DeliveredFrames;
+	}
+
+	TSharedPtr<IMediaAudioSample, ESPMode::ThreadSafe> AudioSample;
+
+	while (Samples.FetchAudio(AllTime, AudioSample)) { }
+
+	// resource usage
+	Current.PeakMemory = FMath::Max(Current.PeakMemory, (uint64)FPlatformMemory::GetStats().UsedPhysical);
+
+	// advance to next file when done or stuck
+	const double Elapsed = FPlatformTime::Seconds() - CurrentStartTime;
+	const double Timeout = 30.0 + 2.0 * Player->GetControls().GetDuration().GetTotalSeconds() / FMath::Max(Rate, 0.1f);
+
+	if (EndReached || (Elapsed > Timeout))
+	{
+		FinishFile();
+		OpenNextFile();
+	}
+
+	return true;
+}
+
+
+void FVlcMediaBenchmark::OpenNextFile()
+{
+	while (++FileIndex < Files.Num() * RunsPerFile)
+	{
+		const FString FilePath = FPaths::ConvertRelativePathToFull(Files[FileIndex / RunsPerFile]);
+		const FString Url = FString(TEXT("file://")) + FilePath;
+		const int32 Run = FileIndex % RunsPerFile;
+
+		if ((RunsPerFile > 1) && (Run == 0))
+		{
+			WarmUpFile(FilePath);
+		}
+
+		Current = FResult();
+		Current.Dim = FIntPoint::ZeroValue;
+		Current.File = FilePath;
+		Current.StartMemory = FPlatformMemory::GetStats().UsedPhysical;
+		Current.PeakMemory = Current.StartMemory;
+		CurrentStartCpuTime = VlcMediaBenchmark::GetProcessCpuTime();
+		CurrentStartTime = FPlatformTime::Seconds();
+		EndReached = false;
+
+		bool Opened = false;
+
+		// when comparing, every other file streams through an archive first, so neither access mode always goes first
+		if ((RunsPerFile > 1) && (Run == (FileIndex / RunsPerFile) % 2))
+		{
+			TSharedPtr<FArchive, ESPMode::ThreadSafe> Archive = MakeShareable(IFileManager::Get().CreateFileReader(*FilePath));
+			Opened = Archive.IsValid() && Player->Open(Archive.ToSharedRef(), Url, nullptr);
+		}
+		else
+		{
+			Opened = Player->Open(Url, nullptr);
+		}
+
+		if (Opened && Player->GetControls().SetRate(Rate))
+		{
+			return;
+		}
+
+		UE_LOG(LogVlcMedia, Warning, TEXT("Benchmark: Failed to play %s"), *FilePath);
+	}
+
+	WriteReport();
+
+	if (ExitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+
+void FVlcMediaBenchmark::WarmUpFile(const FString& FilePath)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+
+	if (!Reader.IsValid())
+	{
+		return;
+	}
+
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(VlcMediaBenchmark::WarmUpBufferSize);
+
+	for (int64 Remaining = Reader->TotalSize(); (Remaining > 0) && !Reader->IsError(); Remaining -= Buffer.Num())
+	{
+		Reader->Serialize(Buffer.GetData(), FMath::Min<int64>(Buffer.Num(), Remaining));
+	}
+}
+
+
+void FVlcMediaBenchmark::WriteReport()
+{
+	TArray<FString> Rows;
+	Rows.Add(TEXT("File,Access,Width,Height,Completed,Decoded Frames,Delivered Frames,Dropped Frames,Seconds,Decoded FPS,Rate Limited,CPU ms/Frame,Peak Process Memory (MB),Process Memory Growth (MB),Bytes Read,Read MB/s"));
+
+	TMap<FIntPoint, TArray<const FResult*>> ResultsByDim;
+
+	for (const FResult& Result : Results)
+	{
+		const double Fps = (Result.WallSeconds > 0.0) ? Result.DecodedFrames / Result.WallSeconds : 0.0;
+		const double CpuPerFrame = (Result.DecodedFrames > 0) ? 1000.0 * Result.CpuSeconds / Result.DecodedFrames : 0.0;
+
+		Rows.Add(FString::Printf(TEXT("\"%s\",%s,%i,%i,%i,%i,%i,%i,%.3f,%.2f,%i,%.3f,%.1f,%.1f,%lld,%.2f"),
+			*Result.File,
+			Result.NativeAccess ? TEXT("path") : TEXT("archive"),
+			Result.Dim.X,
+			Result.Dim.Y,
+			Result.Completed ? 1 : 0,
+			Result.DecodedFrames,
+			Result.DeliveredFrames,
+			Result.DroppedFrames,
+			Result.WallSeconds,
+			Fps,
+			Result.RateLimited ? 1 : 0,
+			CpuPerFrame,
+			Result.PeakMemory / (1024.0 * 1024.0),
+			(Result.PeakMemory - Result.StartMemory) / (1024.0 * 1024.0),
+			Result.BytesRead,
+			(Result.WallSeconds > 0.0) ? Result.BytesRead / (1024.0 * 1024.0 * Result.WallSeconds) : 0.0
+		));
+
+		ResultsByDim.FindOrAdd(Result.Dim).Add(&Result);
+	}
+
+	// summary per resolution
+	for (const auto& Pair : ResultsByDim)
+	{
+		int32 DecodedFrames = 0;
+		int32 DroppedFrames = 0;
+		int32 RateLimitedFiles = 0;
+		double CpuSeconds = 0.0;
+		double WallSeconds = 0.0;
+
+		for (const FResult* Result : Pair.Value)
+		{
+			CpuSeconds += Result->CpuSeconds;
+			DecodedFrames += Result->DecodedFrames;
+			DroppedFrames += Result->DroppedFrames;
+			RateLimitedFiles += Result->RateLimited ? 1 : 0;
+			WallSeconds += Result->WallSeconds;
+		}
+
+		UE_LOG(LogVlcMedia, Log, TEXT("Benchmark: %ix%i: %i files (%i rate-limited), %.1f fps, %.3f CPU ms/frame, %i dropped"),
+			Pair.Key.X,
+			Pair.Key.Y,
+			Pair.Value.Num(),
+			RateLimitedFiles,
+			(WallSeconds > 0.0) ? DecodedFrames / WallSeconds : 0.0,
+			(DecodedFrames > 0) ? 1000.0 * CpuSeconds / DecodedFrames : 0.0,
+			DroppedFrames
+		);
+	}
+
+	// summary per file access
+	if (RunsPerFile > 1)
+	{
+		for (const bool NativeAccess : { false, true })
+		{
+			int64 BytesRead = 0;
+			double CpuSeconds = 0.0;
+			int32 DecodedFrames = 0;
+			double WallSeconds = 0.0;
+
+			for (const FResult& Result : Results)
+			{
+				if (Result.NativeAccess == NativeAccess)
+				{
+					BytesRead += Result.BytesRead;
+					CpuSeconds += Result.CpuSeconds;
+					DecodedFrames += Result.DecodedFrames;
+					WallSeconds += Result.WallSeconds;
+				}
+			}
+
+			UE_LOG(LogVlcMedia, Log, TEXT("Benchmark: %s access: %.1f MB/s read, %.3f CPU ms/frame"),
+				NativeAccess ? TEXT("Path") : TEXT("Archive"),
+				(WallSeconds > 0.0) ? BytesRead / (1024.0 * 1024.0 * WallSeconds) : 0.0,
+				(DecodedFrames > 0) ? 1000.0 * CpuSeconds / DecodedFrames : 0.0
+			);
+		}
+	}
+
+	if (FFileHelper::SaveStringArrayToFile(Rows, *ReportPath))
+	{
+		UE_LOG(LogVlcMedia, Log, TEXT("Benchmark: Wrote report to %s"), *ReportPath);
+	}
+	else
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Benchmark: Failed to write report to %s"), *ReportPath);
+	}
+}
@@ -0,0 +1,208 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "IMediaEventSink.h"
+
+class FVlcMediaPlayer;
+
+struct FLibvlcInstance;
+
+
+/**
+ * Measures the decoding throughput of VLC media players without rendering.
+ *
+ * The benchmark plays a list of media files one after another at the given
+ * rate and discards all output samples. For each file it reports the number
+ * of decoded frames per second, the CPU time per decoded frame, the peak
+ * process memory, and the number of dropped frames. A summary per video
+ * resolution is written to the log and, together with the per-file results,
+ * to a CSV file.
+ *
+ * VLC paces decoding by its clock even without audio and video outputs, and
+ * it doesn't play faster than 32x. Files whose decoding kept up with the
+ * playback rate are therefore marked as rate-limited: their frame rate is
+ * the rate cap, not the decoder's throughput. Memory is measured for the
+ * whole process, so it includes everything else that runs alongside.
+ *
+ * Since no textures are created, the benchmark also runs on machines without
+ * a GPU (i.e. with -nullrhi).
+ *
+ * To compare the two ways of reading local files, each file can be played
+ * twice: streamed to VLC through an engine archive, and read by VLC from its
+ * path. The input read throughput of both runs is reported. Each file is
+ * read once before its runs, so that both are served from the OS file cache,
+ * and the order of the runs alternates between files.
+ */
+class FVlcMediaBenchmark
+	: public IMediaEventSink
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InVlcInstance The LibVLC instance to use.
+	 * @param InFiles The media files to play.
+	 * @param InRate The playback rate to use.
+	 * @param InReportPath Path to the CSV report file.
+	 * @param InExitWhenDone Whether to exit the application when the benchmark completed.
+	 * @param InCompareAccess Whether to play each file streamed from an archive and read from its path.
+	 */
+	FVlcMediaBenchmark(FLibvlcInstance* InVlcInstance, const TArray<FString>& InFiles, float InRate, const FString& InReportPath, bool InExitWhenDone, bool InCompareAccess);
+
+	/** Virtual destructor. */
+	virtual ~FVlcMediaBenchmark();
+
+public:
+
+	/**
+	 * Check whether the benchmark completed.
+	 *
+	 * @return true if all files were played, false otherwise.
+	 */
+	bool IsDone() const
+	{
+		return (FileIndex >= Files.Num() * RunsPerFile);
+	}
+
+	/** Start the benchmark. */
+	void Start();
+
+public:
+
+	//~ IMediaEventSink interface
+
+	virtual void ReceiveMediaEvent(EMediaEvent Event) override;
+
+public:
+
+	/**
+	 * Parse the arguments of the VlcMedia.Benchmark console command.
+	 *
+	 * Arguments are either file paths, directories (all files in it whose
+	 * extensions the VlcMedia player factory supports will be added),
+	 * -rate=<Rate>, -report=<FilePath>, -compareaccess or -exit.
+	 *
+	 * @param Args The command arguments.
+	 * @param OutFiles Will contain the media files.
+	 * @param OutRate Will contain the playback rate.
+	 * @param OutReportPath Will contain the report file path.
+	 * @param OutExitWhenDone Will indicate whether to exit when done.
+	 * @param OutCompareAccess Will indicate whether to compare file access modes.
+	 */
+	static void ParseArgs(const TArray<FString>& Args, TArray<FString>& OutFiles, float& OutRate, FString& OutReportPath, bool& OutExitWhenDone, bool& OutCompareAccess);
+
+protected:
+
+	/** Finish the current file and record its results. */
+	void FinishFile();
+
+	/** Handles ticker callbacks. */
+	bool HandleTicker(float DeltaTime);
+
+	/** Open the next file. */
+	void OpenNextFile();
+
+	/**
+	 * Read a file once, so that it is in the OS file cache for all of its runs.
+	 *
+	 * @param FilePath The file to read.
+	 */
+	void WarmUpFile(const FString& FilePath);
+
+	/** Write the benchmark results to the log and report file. */
+	void WriteReport();
+
+private:
+
+	/** Results for a single media file. */
+	struct FResult
+	{
+		/** Number of bytes read by VLC's input. */
+		int64 BytesRead;
+
+		/** User and kernel CPU time that the process used while playing the file (in seconds). */
+		double CpuSeconds;
+
+		/** Number of decoded video frames. */
+		int32 DecodedFrames;
+
+		/** Number of video samples received by the null sink. */
+		int32 DeliveredFrames;
+
+		/** Video dimensions. */
+		FIntPoint Dim;
+
+		/** Number of dropped video frames. */
+		int32 DroppedFrames;
+
+		/** Frame rate of the video track (zero if unknown). */
+		float FrameRate;
+
+		/** The media file. */
+		FString File;
+
+		/** Whether VLC read the file from its path rather than from an archive. */
+		bool NativeAccess;
+
+		/** Peak used physical memory of the process (in bytes). */
+		uint64 PeakMemory;
+
+		/** Used physical memory of the process when the file was opened (in bytes). */
+		uint64 StartMemory;
+
+		/** Whether the file played to the end. */
+		bool Completed;
+
+		/** Whether decoding kept up with the playback rate, which then limited the frame rate. */
+		bool RateLimited;
+
+		/** Wall clock time spent playing the file (in seconds). */
+		double WallSeconds;
+	};
+
+	/** Results of the file being played. */
+	FResult Current;
+
+	/** Process CPU time at which the current file was opened (in seconds). */
+	double CurrentStartCpuTime;
+
+	/** Time at which the current file was opened (in seconds). */
+	double CurrentStartTime;
+
+	/** Whether the current file reached its end. */
+	bool EndReached;
+
+	/** Whether to exit the application when done. */
+	bool ExitWhenDone;
+
+	/** Index of the current run (each file is played RunsPerFile times). */
+	int32 FileIndex;
+
+	/** The media files to play. */
+	TArray<FString> Files;
+
+	/** The player being benchmarked. */
+	TSharedPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player;
+
+	/** The playback rate. */
+	float Rate;
+
+	/** Path to the CSV report file. */
+	FString ReportPath;
+
+	/** Collected results. */
+	TArray<FResult> Results;
+
+	/** Number of times each file is played (two when comparing file access modes). */
+	int32 RunsPerFile;
+
+	/** Handle to the registered ticker. */
+	FDelegateHandle TickerHandle;
+
+	/** The LibVLC instance. */
+	FLibvlcInstance* VlcInstance;
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreTypes.h"
+#include "HAL/PlatformTime.h"
 #include "IMediaAudioSample.h"
 #include "MediaObjectPool.h"
 #include "Misc/Timespan.h"
@@ -24,7 +25,9 @@ public:
 		, BufferSize(0)
 		, Channels(0)
 		, Duration(FTimespan::Zero())
+		, EnqueueCycles(0)
 		, Frames(0)
+		, PresentationTimestamp(0)
 		, SampleFormat(EMediaAudioSampleFormat::Undefined)
 		, SampleRate(0)
 		, Time(FTimespan::Zero())
@@ -49,6 +52,7 @@ public:
 	 * @param InSampleRate The sample rate.
 	 * @param InTime The sample time (in the player's local clock).
 	 * @param InDuration The duration for which the sample is valid.
+	 * @param InPresentationTimestamp The time at which VLC intended the sample to be played (in LibVLC clock microseconds).
 	 * @return true on success, false otherwise.
 	 */
 	bool Initialize(
@@ -59,7 +63,8 @@ public:
 		EMediaAudioSampleFormat InSampleFormat,
 		uint32 InSampleRate,
 		FTimespan InTime,
-		FTimespan InDuration)
+		FTimespan InDuration,
+		int64 InPresentationTimestamp)
 	{
 		if ((InBuffer == nullptr) || (InBufferSize == 0) || (InSampleFormat == EMediaAudioSampleFormat::Undefined))
 		{
@@ -76,7 +81,9 @@ public:
 
 		Channels = InChannels;
 		Duration = InDuration;
+		EnqueueCycles = FPlatformTime::Cycles64();
 		Frames = InFrames;
+		PresentationTimestamp = InPresentationTimestamp;
 		SampleFormat = InSampleFormat;
 		SampleRate = InSampleRate;
 		Time = InTime;
@@ -84,6 +91,26 @@ public:
 		return true;
 	}
 
+	/**
+	 * Get the time at which the sample was added to the output queue.
+	 *
+	 * @return Time in cycles (see FPlatformTime::Cycles64).
+	 */
+	uint64 GetEnqueueCycles() const
+	{
+		return EnqueueCycles;
+	}
+
+	/**
+	 * Get the time at which VLC intended the sample to be played.
+	 *
+	 * @return Time in LibVLC clock microseconds (see FVlc::Clock).
+	 */
+	int64 GetPresentationTimestamp() const
+	{
+		return PresentationTimestamp;
+	}
+
 public:
 
 	//~ IMediaAudioSample interface
@@ -151,9 +178,15 @@ private:
 	/** Duration for which the sample is valid. */
 	FTimespan Duration;
 
+	/** Time at which the sample was added to the output queue (in cycles). */
+	uint64 EnqueueCycles;
+
 	/** Number of frames in the buffer. */
 	uint32 Frames;
 
+	/** Time at which VLC intended the sample to be played (in LibVLC clock microseconds). */
+	int64 PresentationTimestamp;
+
 	/** The sample format. */
 	EMediaAudioSampleFormat SampleFormat;
 
@@ -6,11 +6,21 @@
 #include "IMediaAudioSample.h"
 #include "IMediaOptions.h"
 #include "IMediaTextureSample.h"
-#include "MediaSamples.h"
+#include "Misc/ScopeLock.h"
 
 #include "Vlc.h"
 #include "VlcMediaAudioSample.h"
+#include "VlcMediaSamples.h"
+#include "VlcMediaStats.h"
 #include "VlcMediaTextureSample.h"
+#include "VlcMediaUtils.h"
+
+
+namespace VlcMediaCallbacks
+{
+	/** Number of video samples to allocate before playback starts. */
+	const int32 NumPrewarmedVideoSamples = 4;
+}
 
 
 /* FVlcMediaOutput structors
@@ -18,17 +28,26 @@
 
 FVlcMediaCallbacks::FVlcMediaCallbacks()
 	: AudioChannels(0)
+	, AudioPreviousCycles(0)
 	, AudioSampleFormat(EMediaAudioSampleFormat::Int16)
 	, AudioSamplePool(new FVlcMediaAudioSamplePool)
 	, AudioSampleRate(0)
 	, AudioSampleSize(0)
 	, CurrentTime(FTimespan::Zero())
+	, DiscardTime(FTimespan::Zero())
+	, MaxOutputDim(0)
 	, Player(nullptr)
-	, Samples(new FMediaSamples)
+	, Samples(new FVlcMediaSamples)
+	, SkipDuplicateFrames(false)
 	, VideoBufferDim(FIntPoint::ZeroValue)
 	, VideoBufferStride(0)
+	, VideoDecimated(0)
+	, VideoDeliveryInterval(FTimespan::Zero())
+	, VideoDuplicates(0)
 	, VideoFrameDuration(FTimespan::Zero())
 	, VideoOutputDim(FIntPoint::ZeroValue)
+	, VideoPoolBufferSize(0)
+	, VideoPreviousCycles(0)
 	, VideoPreviousTime(FTimespan::MinValue())
 	, VideoSampleFormat(EMediaTextureSampleFormat::CharAYUV)
 	, VideoSamplePool(new FVlcMediaTextureSamplePool)
@@ -53,12 +72,48 @@ FVlcMediaCallbacks::~FVlcMediaCallbacks()
 /* FVlcMediaOutput interface
  *****************************************************************************/
 
-IMediaSamples& FVlcMediaCallbacks::GetSamples()
+void FVlcMediaCallbacks::FlushHeldVideoSample()
+{
+	FScopeLock Lock(&VideoHeldCriticalSection);
+
+	if (!VideoHeldSample.IsValid())
+	{
+		return;
+	}
+
+	const uint64 Cycles = FPlatformTime::Cycles64();
+
+	VideoHeldSample->SetEnqueueCycles(Cycles);
+	Samples->RecordVideoDecode(VideoHeldSample->GetDecodeCycles(), Cycles);
+	Samples->AddVideo(VideoHeldSample.ToSharedRef());
+	VideoHeldSample.Reset();
+}
+
+
+const FVlcMediaSampleLatencies& FVlcMediaCallbacks::GetLatencies() const
+{
+	return Samples->GetLatencies();
+}
+
+
+FVlcMediaSamples& FVlcMediaCallbacks::GetSamples()
 {
 	return *Samples;
 }
 
 
+void FVlcMediaCallbacks::GetStats(FVlcMediaPlayerStats& OutStats) const
+{
+	OutStats.AudioSampleQueue = Samples->NumAudio();
+	OutStats.VideoSampleQueue = Samples->NumVideoSamples();
+	OutStats.AudioSamplePool = AudioSamplePool->Num();
+	OutStats.VideoSamplePool = VideoSamplePool->Num();
+	OutStats.SkippedVideoSamples = Samples->GetNumSkippedVideo();
+	OutStats.DecimatedVideoSamples = VideoDecimated;
+	OutStats.DuplicateVideoSamples = VideoDuplicates;
+}
+
+
 void FVlcMediaCallbacks::Initialize(FLibvlcMediaPlayer& InPlayer)
 {
 	Shutdown();
@@ -98,6 +153,85 @@ void FVlcMediaCallbacks::Initialize(FLibvlcMediaPlayer& InPlayer)
 }
 
 
+FIntPoint FVlcMediaCallbacks::GetOutputDim(const FIntPoint& Dim) const
+{
+	if ((MaxOutputDim <= 0) || (Dim.GetMax() <= MaxOutputDim))
+	{
+		return Dim;
+	}
+
+	// keep the aspect ratio, and even dimensions for packed YUV formats
+	const float Scale = (float)MaxOutputDim / Dim.GetMax();
+
+	return FIntPoint(
+		FMath::Max(2, FMath::RoundToInt(Dim.X * Scale) & ~1),
+		FMath::Max(2, FMath::RoundToInt(Dim.Y * Scale) & ~1)
+	);
+}
+
+
+void FVlcMediaCallbacks::PrewarmVideoSamples(const FIntPoint& SourceDim)
+{
+	const FIntPoint Dim = GetOutputDim(SourceDim);
+
+	if (Dim.GetMin() <= 0)
+	{
+		return;
+	}
+
+	// large enough for any of the layouts chosen in StaticVideoSetupCallback
+	const FIntPoint BufferDim(Align(Dim.X, 16), Align(Dim.Y, 16));
+	const uint32 BufferStride = BufferDim.X * 4;
+	const SIZE_T BufferSize = BufferStride * BufferDim.Y;
+
+	FScopeLock Lock(&VideoPoolCriticalSection);
+
+	if (BufferSize <= VideoPoolBufferSize)
+	{
+		return; // pooled samples already fit
+	}
+
+	VideoSamplePool->Reset();
+	VideoPoolBufferSize = BufferSize;
+
+	// samples return to the pool when the array is destroyed
+	TArray<TSharedRef<FVlcMediaTextureSample, ESPMode::ThreadSafe>> Prewarmed;
+
+	for (int32 SampleIndex = 0; SampleIndex < VlcMediaCallbacks::NumPrewarmedVideoSamples; ++SampleIndex)
+	{
+		auto VideoSample = VideoSamplePool->AcquireShared();
+		VideoSample->Initialize(BufferDim, Dim, EMediaTextureSampleFormat::CharBGRA, BufferStride, FTimespan::Zero());
+		Prewarmed.Add(VideoSample);
+	}
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Callbacks %llx: Prewarmed %i video samples for %ix%i"), this, Prewarmed.Num(), Dim.X, Dim.Y);
+}
+
+
+void FVlcMediaCallbacks::Reset()
+{
+	Samples->FlushSamples();
+
+	AudioPreviousCycles = 0;
+	CurrentTime = FTimespan::Zero();
+	DiscardTime = FTimespan::Zero();
+	VideoDecimated = 0;
+	VideoDuplicates = 0;
+	VideoPreviousCycles = 0;
+	VideoPreviousTime = FTimespan::MinValue();
+
+	{
+		FScopeLock Lock(&VideoHeldCriticalSection);
+
+		VideoHeldSample.Reset();
+		VideoPreviousSample.Reset();
+	}
+
+	Samples->ResetLatencies();
+	Timings.Reset();
+}
+
+
 void FVlcMediaCallbacks::Shutdown()
 {
 	if (Player == nullptr)
@@ -112,11 +246,21 @@ void FVlcMediaCallbacks::Shutdown()
 	FVlc::VideoSetCallbacks(Player, nullptr, nullptr, nullptr, nullptr);
 	FVlc::VideoSetFormatCallbacks(Player, nullptr, nullptr);
 
+	VideoHeldSample.Reset();
+	VideoPreviousSample.Reset();
+
 	AudioSamplePool->Reset();
 	VideoSamplePool->Reset();
 
 	CurrentTime = FTimespan::Zero();
 	Player = nullptr;
+	VideoPoolBufferSize = 0;
+}
+
+
+void FVlcMediaCallbacks::UpdateLatencies()
+{
+	Samples->UpdateLatencies();
 }
 
 
@@ -158,6 +302,24 @@ void FVlcMediaCallbacks::StaticAudioPlayCallback(void* Opaque, void* Samples, ui
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_AudioPlay);
+	FVlcMediaScopedTimer ScopedTimer(Callbacks->Timings.AudioPlay);
+
+	const uint64 Cycles = FPlatformTime::Cycles64();
+
+	if (Callbacks->AudioPreviousCycles != 0)
+	{
+		Callbacks->Timings.AudioInterval.AddCycles(Cycles - Callbacks->AudioPreviousCycles);
+	}
+
+	Callbacks->AudioPreviousCycles = Cycles;
+
+	// skip if decoded on the way to a seek target
+	if (Callbacks->CurrentTime < Callbacks->DiscardTime)
+	{
+		return;
+	}
+
 	UE_LOG(LogVlcMedia, VeryVerbose, TEXT("Callbacks %llx: StaticAudioPlayCallback (Count = %i, Timestamp = %i, Queue = %i)"),
 		Opaque,
 		Count,
@@ -180,7 +342,8 @@ void FVlcMediaCallbacks::StaticAudioPlayCallback(void* Opaque, void* Samples, ui
 		Callbacks->AudioSampleFormat,
 		Callbacks->AudioSampleRate,
 		Callbacks->CurrentTime + Delay,
-		Duration))
+		Duration,
+		Timestamp))
 	{
 		Callbacks->Samples->AddAudio(AudioSample);
 	}
@@ -204,6 +367,9 @@ int FVlcMediaCallbacks::StaticAudioSetupCallback(void** Opaque, ANSICHAR* Format
 		return -1;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_AudioSetup);
+	FVlcMediaScopedTimer ScopedTimer(Callbacks->Timings.AudioSetup);
+
 	UE_LOG(LogVlcMedia, VeryVerbose, TEXT("Callbacks %llx: StaticAudioSetupCallback (Format = %s, Rate = %i, Channels = %i)"),
 		Opaque,
 		ANSI_TO_TCHAR(Format),
@@ -211,6 +377,8 @@ int FVlcMediaCallbacks::StaticAudioSetupCallback(void** Opaque, ANSICHAR* Format
 		*Channels
 	);
 
+	const EMediaAudioSampleFormat PreviousSampleFormat = Callbacks->AudioSampleFormat;
+
 	// setup audio format
 	if (*Channels > 8)
 	{
@@ -257,6 +425,14 @@ int FVlcMediaCallbacks::StaticAudioSetupCallback(void** Opaque, ANSICHAR* Format
 		Callbacks->AudioSampleSize = 2;
 	}
 
+	// discard pooled samples if the format changed
+	if ((Callbacks->AudioChannels != *Channels) ||
+		(Callbacks->AudioSampleFormat != PreviousSampleFormat) ||
+		(Callbacks->AudioSampleRate != *Rate))
+	{
+		Callbacks->AudioSamplePool->Reset();
+	}
+
 	Callbacks->AudioChannels = *Channels;
 	Callbacks->AudioSampleRate = *Rate;
 
@@ -280,6 +456,18 @@ void FVlcMediaCallbacks::StaticVideoDisplayCallback(void* Opaque, void* Picture)
 		return;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_VideoDisplay);
+	FVlcMediaScopedTimer ScopedTimer(Callbacks->Timings.VideoDisplay);
+
+	const uint64 Cycles = FPlatformTime::Cycles64();
+
+	if (Callbacks->VideoPreviousCycles != 0)
+	{
+		Callbacks->Timings.VideoInterval.AddCycles(Cycles - Callbacks->VideoPreviousCycles);
+	}
+
+	Callbacks->VideoPreviousCycles = Cycles;
+
 	UE_LOG(LogVlcMedia, VeryVerbose, TEXT("Callbacks %llx: StaticVideoDisplayCallback (CurrentTime = %s, Queue = %i)"),
 		Opaque, *Callbacks->CurrentTime.ToString(),
 		Callbacks->Samples->NumVideoSamples()
@@ -287,8 +475,44 @@ void FVlcMediaCallbacks::StaticVideoDisplayCallback(void* Opaque, void* Picture)
 
 	VideoSample->SetTime(Callbacks->CurrentTime);
 
+	TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe> SharedSample = Callbacks->VideoSamplePool->ToShared(VideoSample);
+
+	if (Callbacks->SkipDuplicateFrames)
+	{
+		FScopeLock Lock(&Callbacks->VideoHeldCriticalSection);
+
+		const TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe>& PreviousSample = Callbacks->VideoPreviousSample;
+
+		if (PreviousSample.IsValid() &&
+			(PreviousSample->GetHash() == VideoSample->GetHash()) &&
+			(PreviousSample->GetDim() == VideoSample->GetDim()) &&
+			(PreviousSample->GetFormat() == VideoSample->GetFormat()))
+		{
+			// keep showing the previous frame (it is only extended if it wasn't queued yet); this one returns to the pool
+			if (Callbacks->VideoHeldSample.IsValid())
+			{
+				Callbacks->VideoHeldSample->SetDuration(VideoSample->GetTime() + VideoSample->GetDuration() - Callbacks->VideoHeldSample->GetTime());
+			}
+
+			++Callbacks->VideoDuplicates;
+
+			return;
+		}
+
+		// the held back frame's duration is final now, and this one is held back instead
+		Callbacks->VideoPreviousSample = SharedSample;
+		Swap(SharedSample, Callbacks->VideoHeldSample);
+
+		if (!SharedSample.IsValid())
+		{
+			return;
+		}
+	}
+
 	// add sample to queue
-	Callbacks->Samples->AddVideo(Callbacks->VideoSamplePool->ToShared(VideoSample));
+	SharedSample->SetEnqueueCycles(Cycles);
+	Callbacks->Samples->RecordVideoDecode(SharedSample->GetDecodeCycles(), Cycles);
+	Callbacks->Samples->AddVideo(SharedSample.ToSharedRef());
 }
 
 
@@ -297,6 +521,9 @@ void* FVlcMediaCallbacks::StaticVideoLockCallback(void* Opaque, void** Planes)
 	auto Callbacks = (FVlcMediaCallbacks*)Opaque;
 	check(Callbacks != nullptr);
 
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_VideoLock);
+	FVlcMediaScopedTimer ScopedTimer(Callbacks->Timings.VideoLock);
+
 	FMemory::Memzero(Planes, FVlc::MaxPlanes * sizeof(void*));
 
 	// skip if already processed
@@ -307,6 +534,26 @@ void* FVlcMediaCallbacks::StaticVideoLockCallback(void* Opaque, void** Planes)
 		return nullptr;
 	}
 
+	// skip if decoded on the way to a seek target
+	if (Callbacks->CurrentTime < Callbacks->DiscardTime)
+	{
+		// VLC currently requires a valid buffer or it will crash
+		Planes[0] = FMemory::Malloc(Callbacks->VideoBufferStride * Callbacks->VideoBufferDim.Y, 32);
+		return nullptr;
+	}
+
+	// skip if delivery rate is limited and the previous frame isn't due yet (time goes backwards after seeking)
+	if ((Callbacks->VideoDeliveryInterval > FTimespan::Zero()) &&
+		(Callbacks->CurrentTime > Callbacks->VideoPreviousTime) &&
+		(Callbacks->CurrentTime < Callbacks->VideoPreviousTime + Callbacks->VideoDeliveryInterval))
+	{
+		++Callbacks->VideoDecimated;
+
+		// VLC currently requires a valid buffer or it will crash
+		Planes[0] = FMemory::Malloc(Callbacks->VideoBufferStride * Callbacks->VideoBufferDim.Y, 32);
+		return nullptr;
+	}
+
 	UE_LOG(LogVlcMedia, VeryVerbose, TEXT("Callbacks %llx: StaticVideoLockCallback (CurrentTime = %s)"),
 		Opaque,
 		*Callbacks->CurrentTime.ToString()
@@ -351,6 +598,9 @@ unsigned FVlcMediaCallbacks::StaticVideoSetupCallback(void** Opaque, char* Chrom
 		return 0;
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_VideoSetup);
+	FVlcMediaScopedTimer ScopedTimer(Callbacks->Timings.VideoSetup);
+
 	UE_LOG(LogVlcMedia, VeryVerbose, TEXT("Callbacks %llx: StaticVideoSetupCallback (Chroma = %s, Dim = %ix%i)"),
 		Opaque,
 		ANSI_TO_TCHAR(Chroma),
@@ -374,9 +624,23 @@ unsigned FVlcMediaCallbacks::StaticVideoSetupCallback(void** Opaque, char* Chrom
 	}
 
 	// determine decoder & sample formats
+	const FIntPoint ScaledDim = Callbacks->GetOutputDim(Callbacks->VideoOutputDim);
+
 	Callbacks->VideoBufferDim = FIntPoint(*Width, *Height);
 
-	if (FCStringAnsi::Stricmp(Chroma, "AYUV") == 0)
+	if (ScaledDim != Callbacks->VideoOutputDim)
+	{
+		// have the converter downscale into the smallest packed format
+		FMemory::Memcpy(Chroma, "YUY2", 4);
+
+		Callbacks->VideoOutputDim = ScaledDim;
+		Callbacks->VideoBufferDim = FIntPoint(Align(ScaledDim.X, 16) / 2, Align(ScaledDim.Y, 16));
+		Callbacks->VideoSampleFormat = EMediaTextureSampleFormat::CharYUY2;
+		Callbacks->VideoBufferStride = Callbacks->VideoBufferDim.X * 4;
+		*Width = ScaledDim.X;
+		*Height = ScaledDim.Y;
+	}
+	else if (FCStringAnsi::Stricmp(Chroma, "AYUV") == 0)
 	{
 		Callbacks->VideoSampleFormat = EMediaTextureSampleFormat::CharAYUV;
 		Callbacks->VideoBufferStride = *Width * 4;
@@ -435,6 +699,19 @@ unsigned FVlcMediaCallbacks::StaticVideoSetupCallback(void** Opaque, char* Chrom
 		}
 	}
 
+	// discard pooled samples if their buffers are too small or wasteful
+	{
+		const SIZE_T RequiredBufferSize = Callbacks->VideoBufferStride * Callbacks->VideoBufferDim.Y;
+
+		FScopeLock Lock(&Callbacks->VideoPoolCriticalSection);
+
+		if ((RequiredBufferSize > Callbacks->VideoPoolBufferSize) || (RequiredBufferSize < Callbacks->VideoPoolBufferSize / 4))
+		{
+			Callbacks->VideoSamplePool->Reset();
+			Callbacks->VideoPoolBufferSize = RequiredBufferSize;
+		}
+	}
+
 	// get other video properties
 	Callbacks->VideoFrameDuration = FTimespan::FromSeconds(1.0 / FVlc::MediaPlayerGetFps(Callbacks->Player));
 
@@ -448,9 +725,25 @@ unsigned FVlcMediaCallbacks::StaticVideoSetupCallback(void** Opaque, char* Chrom
 
 void FVlcMediaCallbacks::StaticVideoUnlockCallback(void* Opaque, void* Picture, void* const* Planes)
 {
-	if ((Opaque != nullptr) && (Picture != nullptr))
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_VideoUnlock);
+
+	auto Callbacks = (FVlcMediaCallbacks*)Opaque;
+	check(Callbacks != nullptr);
+
+	FVlcMediaScopedTimer ScopedTimer(Callbacks->Timings.VideoUnlock);
+
+	if (Picture != nullptr)
 	{
 		UE_LOG(LogVlcMedia, VeryVerbose, TEXT("Callbacks %llx: StaticVideoUnlockCallback"), Opaque);
+
+		// the decoder finished writing the picture
+		auto VideoSample = (FVlcMediaTextureSample*)Picture;
+		VideoSample->SetDecodeCycles(FPlatformTime::Cycles64());
+
+		if (Callbacks->SkipDuplicateFrames)
+		{
+			VideoSample->SetHash(VlcMedia::HashFrame(VideoSample->GetBuffer(), VideoSample->GetStride() * VideoSample->GetOutputDim().Y));
+		}
 	}
 
 	// discard temporary buffer for VLC crash workaround
@@ -3,11 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
 #include "IMediaAudioSample.h"
 #include "IMediaTextureSample.h"
 
-class FMediaSamples;
+#include "VlcMediaHistogram.h"
+
 class FVlcMediaAudioSamplePool;
+class FVlcMediaSamples;
+class FVlcMediaTextureSample;
 class FVlcMediaTextureSamplePool;
 class IMediaOptions;
 class IMediaAudioSink;
@@ -16,6 +20,54 @@ class IMediaSamples;
 class IMediaTextureSink;
 
 struct FLibvlcMediaPlayer;
+struct FVlcMediaPlayerStats;
+struct FVlcMediaSampleLatencies;
+
+
+/**
+ * Timing histograms for the VLC output callbacks.
+ */
+struct FVlcMediaCallbackTimings
+{
+	/** Time spent in the audio play callback. */
+	FVlcMediaHistogram AudioPlay;
+
+	/** Time spent in the audio setup callback. */
+	FVlcMediaHistogram AudioSetup;
+
+	/** Time between consecutive audio play callbacks. */
+	FVlcMediaHistogram AudioInterval;
+
+	/** Time spent in the video display callback. */
+	FVlcMediaHistogram VideoDisplay;
+
+	/** Time spent in the video lock callback. */
+	FVlcMediaHistogram VideoLock;
+
+	/** Time spent in the video setup callback. */
+	FVlcMediaHistogram VideoSetup;
+
+	/** Time spent in the video unlock callback. */
+	FVlcMediaHistogram VideoUnlock;
+
+	/** Time between consecutive video display callbacks. */
+	FVlcMediaHistogram VideoInterval;
+
+public:
+
+	/** Remove all samples from all histograms. */
+	void Reset()
+	{
+		AudioPlay.Reset();
+		AudioSetup.Reset();
+		AudioInterval.Reset();
+		VideoDisplay.Reset();
+		VideoLock.Reset();
+		VideoSetup.Reset();
+		VideoUnlock.Reset();
+		VideoInterval.Reset();
+	}
+};
 
 
 /**
@@ -33,12 +85,67 @@ public:
 
 public:
 
+	/**
+	 * Deliver the video sample that is held back to detect duplicates of it.
+	 *
+	 * This should be called while playback doesn't advance, i.e. when paused
+	 * or after seeking while paused, so that the most recent frame is shown
+	 * even though no other frame follows it.
+	 *
+	 * @see SetSkipDuplicateFrames
+	 */
+	void FlushHeldVideoSample();
+
 	/**
 	 * Get the output media samples.
 	 *
-	 * @return Media samples interface.
+	 * @return Media samples.
+	 */
+	FVlcMediaSamples& GetSamples();
+
+	/**
+	 * Get the sample queue and pool statistics.
+	 *
+	 * @param OutStats Will contain the sample statistics.
 	 */
-	IMediaSamples& GetSamples();
+	void GetStats(FVlcMediaPlayerStats& OutStats) const;
+
+	/**
+	 * Get the sample latencies of the most recently completed window.
+	 *
+	 * @return Latency histograms.
+	 * @see UpdateLatencies
+	 */
+	const FVlcMediaSampleLatencies& GetLatencies() const;
+
+	/**
+	 * Get the callback timing histograms.
+	 *
+	 * @return Callback timings.
+	 */
+	const FVlcMediaCallbackTimings& GetTimings() const
+	{
+		return Timings;
+	}
+
+	/**
+	 * Get the maximum width or height of the video output.
+	 *
+	 * @return Maximum size (0 = no limit).
+	 * @see SetMaxOutputDim
+	 */
+	int32 GetMaxOutputDim() const
+	{
+		return MaxOutputDim;
+	}
+
+	/**
+	 * Get the output dimensions for video of the given size.
+	 *
+	 * @param Dim The dimensions of the decoded video.
+	 * @return The dimensions limited to the maximum output size (see SetMaxOutputDim).
+	 */
+	FIntPoint GetOutputDim(const FIntPoint& Dim) const;
 
 	/**
 	 * Initialize the handler for the specified media player.
@@ -47,6 +154,26 @@ public:
 	 */
 	void Initialize(FLibvlcMediaPlayer& InPlayer);
 
+	/**
+	 * Pre-allocate video samples for the expected output dimensions.
+	 *
+	 * This avoids buffer allocations when the first frames are decoded. It
+	 * should be called as soon as the video format of a media source is known.
+	 *
+	 * @param SourceDim The expected dimensions of the decoded video.
+	 */
+	void PrewarmVideoSamples(const FIntPoint& SourceDim);
+
+	/**
+	 * Reset the handler's playback state for a new media source.
+	 *
+	 * Pending samples are discarded, but the callbacks remain installed
+	 * and the sample pools are kept for reuse.
+	 *
+	 * @see Initialize, Shutdown
+	 */
+	void Reset();
+
 	/**
 	 * Set the player's current time.
 	 *
@@ -57,9 +184,69 @@ public:
 		CurrentTime = Time;
 	}
 
+	/**
+	 * Limit the rate at which video samples are delivered.
+	 *
+	 * Frames that are decoded less than the given interval of play time after
+	 * the previously delivered one are dropped before they are copied.
+	 *
+	 * @param Interval Minimum play time between delivered frames (zero = deliver all frames).
+	 */
+	void SetDeliveryInterval(FTimespan Interval)
+	{
+		VideoDeliveryInterval = Interval;
+	}
+
+	/**
+	 * Drop the samples that are decoded before the given play time.
+	 *
+	 * This is used while the player decodes from a key frame towards the
+	 * target of a seek, so that the frames in between aren't delivered.
+	 *
+	 * @param Time The play time at which delivery continues (zero = deliver all samples).
+	 */
+	void SetDiscardTime(FTimespan Time)
+	{
+		DiscardTime = Time;
+	}
+
+	/**
+	 * Enable or disable skipping of duplicate video frames.
+	 *
+	 * If enabled, each decoded frame is hashed, and frames that are identical
+	 * to the previously delivered one extend its duration instead of being
+	 * delivered, so that they don't need to be converted and uploaded again.
+	 * Each frame is held back until the next different frame is decoded, so
+	 * that its duration is final by the time it is queued.
+	 *
+	 * @param Enabled Whether to skip duplicate frames.
+	 * @see FlushHeldVideoSample
+	 */
+	void SetSkipDuplicateFrames(bool Enabled)
+	{
+		SkipDuplicateFrames = Enabled;
+	}
+
+	/**
+	 * Limit the size of the video output.
+	 *
+	 * Larger video is downscaled by VLC's chroma converter, which keeps the
+	 * aspect ratio and makes the sample buffers proportionally smaller. This
+	 * must be set before a media source starts playing.
+	 *
+	 * @param InMaxOutputDim The maximum width or height (0 = no limit).
+	 */
+	void SetMaxOutputDim(int32 InMaxOutputDim)
+	{
+		MaxOutputDim = InMaxOutputDim;
+	}
+
 	/** Shut down the callback handler. */
 	void Shutdown();
 
+	/** Start a new sample latency window if the current one expired. */
+	void UpdateLatencies();
+
 private:
 
 	/** Handles audio cleanup callbacks from VLC.*/
@@ -103,6 +290,9 @@ private:
 	/** Current number of channels in audio samples( accessed by VLC thread only). */
 	uint32 AudioChannels;
 
+	/** Time of the previous audio play callback (accessed by VLC thread only). */
+	uint64 AudioPreviousCycles;
+
 	/** Current audio sample format (accessed by VLC thread only). */
 	EMediaAudioSampleFormat AudioSampleFormat;
 
@@ -118,11 +308,32 @@ private:
 	/** The player's current time. */
 	FTimespan CurrentTime;
 
+	/** Play time before which decoded samples are dropped (zero = none). */
+	FTimespan DiscardTime;
+
+	/** Maximum width or height of the video output (0 = no limit). */
+	int32 MaxOutputDim;
+
 	/** The VLC media player object. */
 	FLibvlcMediaPlayer* Player;
 
 	/** The output media samples. */
-	FMediaSamples* Samples;
+	FVlcMediaSamples* Samples;
+
+	/** Whether duplicate video frames are skipped. */
+	bool SkipDuplicateFrames;
+
+	/** Callback timing histograms. */
+	FVlcMediaCallbackTimings Timings;
+
+	/** Number of decoded video frames that were dropped to limit the delivery rate (written by VLC thread only). */
+	int32 VideoDecimated;
+
+	/** Minimum play time between delivered video frames (zero = no limit). */
+	FTimespan VideoDeliveryInterval;
+
+	/** Number of duplicate video frames that were skipped (written by VLC thread only). */
+	int32 VideoDuplicates;
 
 	/** Current video buffer dimensions (accessed by VLC thread only; may be larger than VideoOutputDim). */
 	FIntPoint VideoBufferDim;
@@ -130,12 +341,30 @@ private:
 	/** Number of bytes per row of video pixels. */
 	uint32 VideoBufferStride;
 
+	/** Synchronizes access to the held back and previous video samples. */
+	FCriticalSection VideoHeldCriticalSection;
+
+	/** Video sample that is held back until the next different frame is decoded (only if duplicate frames are skipped). */
+	TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe> VideoHeldSample;
+
 	/** Current duration of video frames. */
 	FTimespan VideoFrameDuration;
 
 	/** Current video output dimensions (accessed by VLC thread only). */
 	FIntPoint VideoOutputDim;
 
+	/** Size of the buffers of the pooled video samples (in bytes). */
+	SIZE_T VideoPoolBufferSize;
+
+	/** Synchronizes access to the video sample pool when it gets reset. */
+	FCriticalSection VideoPoolCriticalSection;
+
+	/** Time of the previous video display callback (accessed by VLC thread only). */
+	uint64 VideoPreviousCycles;
+
+	/** The most recent video sample that wasn't a duplicate (only if duplicate frames are skipped). */
+	TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe> VideoPreviousSample;
+
 	/** Play time of the previous frame. */
 	FTimespan VideoPreviousTime;
 
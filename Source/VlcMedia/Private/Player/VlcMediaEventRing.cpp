@@ -0,0 +1,123 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaEventRing.h"
+#include "VlcMediaPrivate.h"
+
+#include "Misc/ScopeLock.h"
+
+#include "Vlc.h"
+
+
+namespace VlcMediaEventRing
+{
+	/** Maximum number of queued events. */
+	const int32 Capacity = 256;
+}
+
+
+/* FVlcMediaEventRing structors
+ *****************************************************************************/
+
+FVlcMediaEventRing::FVlcMediaEventRing()
+	: Head(0)
+	, NumCoalesced(0)
+	, NumDropped(0)
+	, Tail(0)
+{
+	Events.SetNumZeroed(VlcMediaEventRing::Capacity);
+
+	for (uint64& Sequence : PendingSequence)
+	{
+		Sequence = MAX_uint64;
+	}
+}
+
+
+FVlcMediaEventRing::~FVlcMediaEventRing()
+{ }
+
+
+/* FVlcMediaEventRing interface
+ *****************************************************************************/
+
+bool FVlcMediaEventRing::Dequeue(FLibvlcEvent& OutEvent)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (Head == Tail)
+	{
+		return false;
+	}
+
+	OutEvent = Events[Head % VlcMediaEventRing::Capacity];
+	++Head;
+
+	return true;
+}
+
+
+void FVlcMediaEventRing::Empty()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	Head = Tail;
+}
+
+
+bool FVlcMediaEventRing::Enqueue(const FLibvlcEvent& Event)
+{
+	const int32 Slot = GetCoalescingSlot(Event.Type);
+
+	FScopeLock Lock(&CriticalSection);
+
+	// latest value wins, but the event keeps its place in the queue
+	if ((Slot != INDEX_NONE) && (PendingSequence[Slot] != MAX_uint64) && (PendingSequence[Slot] >= Head))
+	{
+		Events[PendingSequence[Slot] % VlcMediaEventRing::Capacity] = Event;
+		++NumCoalesced;
+
+		return true;
+	}
+
+	if (Tail - Head >= VlcMediaEventRing::Capacity)
+	{
+		if (NumDropped++ == 0)
+		{
+			UE_LOG(LogVlcMedia, Warning, TEXT("Event ring %p is full, dropping events"), this);
+		}
+
+		return false;
+	}
+
+	if (Slot != INDEX_NONE)
+	{
+		PendingSequence[Slot] = Tail;
+	}
+
+	Events[Tail % VlcMediaEventRing::Capacity] = Event;
+	++Tail;
+
+	return true;
+}
+
+
+/* FVlcMediaEventRing implementation
+ *****************************************************************************/
+
+int32 FVlcMediaEventRing::GetCoalescingSlot(ELibvlcEventType Type)
+{
+	switch (Type)
+	{
+	case ELibvlcEventType::MediaPlayerBuffering:
+		return 0;
+
+	case ELibvlcEventType::MediaPlayerPositionChanged:
+		return 1;
+
+	case ELibvlcEventType::MediaPlayerTimeChanged:
+		return 2;
+
+	default:
+		return INDEX_NONE;
+	}
+}
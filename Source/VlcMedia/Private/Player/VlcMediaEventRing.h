@@ -0,0 +1,105 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+enum class ELibvlcEventType;
+
+struct FLibvlcEvent;
+
+
+/**
+ * Bounded queue of VLC events that is allocated up front.
+ *
+ * Events are added by VLC's event threads and removed on the game thread.
+ * High frequency events (buffering, position and time changes) are
+ * coalesced: if one of the same type is still queued, its payload is
+ * replaced with the newer one, so that only the latest value is delivered.
+ * Events that don't fit into the ring are dropped.
+ */
+class FVlcMediaEventRing
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaEventRing();
+
+	/** Destructor. */
+	~FVlcMediaEventRing();
+
+public:
+
+	/**
+	 * Remove the oldest event.
+	 *
+	 * @param OutEvent Will contain the event.
+	 * @return true if an event was removed, false if the ring is empty.
+	 */
+	bool Dequeue(FLibvlcEvent& OutEvent);
+
+	/** Remove all events. */
+	void Empty();
+
+	/**
+	 * Add an event, or replace the payload of a queued event of the same type.
+	 *
+	 * @param Event The event to add.
+	 * @return true if the event was added or coalesced, false if it was dropped.
+	 */
+	bool Enqueue(const FLibvlcEvent& Event);
+
+	/**
+	 * Get the number of events that replaced a queued event.
+	 *
+	 * @return Number of coalesced events.
+	 */
+	int32 GetNumCoalesced() const
+	{
+		return NumCoalesced;
+	}
+
+	/**
+	 * Get the number of events that were dropped because the ring was full.
+	 *
+	 * @return Number of dropped events.
+	 */
+	int32 GetNumDropped() const
+	{
+		return NumDropped;
+	}
+
+protected:
+
+	/**
+	 * Get the coalescing slot of an event type.
+	 *
+	 * @param Type The event type.
+	 * @return Slot index, or INDEX_NONE if events of this type are not coalesced.
+	 */
+	static int32 GetCoalescingSlot(ELibvlcEventType Type);
+
+private:
+
+	/** Synchronizes access from the event threads. */
+	FCriticalSection CriticalSection;
+
+	/** The preallocated events. */
+	TArray<FLibvlcEvent> Events;
+
+	/** Sequence number of the oldest queued event. */
+	uint64 Head;
+
+	/** Number of coalesced events. */
+	int32 NumCoalesced;
+
+	/** Number of dropped events. */
+	int32 NumDropped;
+
+	/** Sequence numbers of the queued events per coalescing slot (MAX_uint64 = none). */
+	uint64 PendingSequence[3];
+
+	/** Sequence number of the next event to add. */
+	uint64 Tail;
+};
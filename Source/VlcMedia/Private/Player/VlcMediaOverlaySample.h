@@ -0,0 +1,72 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IMediaOverlaySample.h"
+
+
+/**
+ * Caption sample generated from a subtitle cue.
+ */
+class FVlcMediaOverlaySample
+	: public IMediaOverlaySample
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InText The caption text.
+	 * @param InTime The time at which the caption appears (in the player's local clock).
+	 * @param InDuration The duration for which the caption is visible.
+	 */
+	FVlcMediaOverlaySample(const FText& InText, FTimespan InTime, FTimespan InDuration)
+		: Duration(InDuration)
+		, Text(InText)
+		, Time(InTime)
+	{ }
+
+	/** Virtual destructor. */
+	virtual ~FVlcMediaOverlaySample() { }
+
+public:
+
+	//~ IMediaOverlaySample interface
+
+	virtual FTimespan GetDuration() const override
+	{
+		return Duration;
+	}
+
+	virtual TOptional<FVector2D> GetPosition() const override
+	{
+		return TOptional<FVector2D>(); // let the sink decide
+	}
+
+	virtual FText GetText() const override
+	{
+		return Text;
+	}
+
+	virtual FTimespan GetTime() const override
+	{
+		return Time;
+	}
+
+	virtual EMediaOverlaySampleType GetType() const override
+	{
+		return EMediaOverlaySampleType::Caption;
+	}
+
+private:
+
+	/** Duration for which the caption is visible. */
+	FTimespan Duration;
+
+	/** The caption text. */
+	FText Text;
+
+	/** Time at which the caption appears. */
+	FTimespan Time;
+};
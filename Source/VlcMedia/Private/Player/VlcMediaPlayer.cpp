@@ -6,28 +6,146 @@
 #include "IMediaEventSink.h"
 #include "IMediaOptions.h"
 #include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 #include "Serialization/ArrayReader.h"
 
 #include "Vlc.h"
+#include "VlcMediaDemuxHints.h"
+#include "VlcMediaProbeIndex.h"
+#include "VlcMediaSamples.h"
+#include "VlcMediaTextureSample.h"
 #include "VlcMediaUtils.h"
 
 
+namespace VlcMediaPlayer
+{
+	/** Highest delivery rate at which the decoder skips B-frames (in frames per second). */
+	const float MaxDecoderSkippingRate = 10.0f;
+
+	/** Highest thinned playback rate. */
+	const float MaxThinnedRate = 16.0f;
+
+	/** Playback rate above which only key frames are decoded. */
+	const float MinThinnedRate = 2.0f;
+
+	/** Highest reverse playback rate (absolute value). */
+	const float MaxReverseRate = 1.0f;
+
+	/** Factor by which playback speeds up while decoding from a key frame towards a seek target. */
+	const float SeekCatchUpFactor = 8.0f;
+}
+
+
 /* FVlcMediaPlayer structors
  *****************************************************************************/
 
-FVlcMediaPlayer::FVlcMediaPlayer(IMediaEventSink& InEventSink, FLibvlcInstance* InVlcInstance)
-	: CurrentRate(0.0f)
+FVlcMediaPlayer::FVlcMediaPlayer(IMediaEventSink& InEventSink, FLibvlcInstance* InVlcInstance, FVlcMediaProbeIndex* InProbeIndex, FVlcMediaDemuxHints* InDemuxHints)
+	: BufferingProgress(100.0f)
+	, CurrentRate(0.0f)
 	, CurrentTime(FTimespan::Zero())
+	, DecodeAudio(true)
+	, DecodeVideo(true)
+	, DecoderScaledDim(FIntPoint::ZeroValue)
+	, DeliveryRate(0.0f)
+	, DemuxHintConfirmed(false)
+	, DemuxHints(InDemuxHints)
 	, EventSink(InEventSink)
+	, ExternalClock(false)
+	, IndexedSeeking(false)
+	, LowLatencyCaching(FTimespan::Zero())
 	, MediaSource(InVlcInstance)
+	, PlayedTime(FTimespan::Zero())
 	, Player(nullptr)
+	, ProbeIndex(InProbeIndex)
+	, RateCorrection(1.0f)
+	, RestartTime(FTimespan::Zero())
+	, SeekResumeRate(0.0f)
+	, SeekTarget(FTimespan::Zero())
 	, ShouldLoop(false)
+	, SkipFrames(EVlcMediaSkipFrames::None)
+	, StepPending(false)
+	, VlcInstance(InVlcInstance)
 { }
 
 
 FVlcMediaPlayer::~FVlcMediaPlayer()
 {
 	Close();
+
+	if (Player != nullptr)
+	{
+		// detach callback handlers
+		Callbacks.Shutdown();
+
+		// release player
+		FVlc::MediaPlayerRelease(Player);
+		Player = nullptr;
+	}
+}
+
+
+/* FVlcMediaPlayer interface
+ *****************************************************************************/
+
+FTimespan FVlcMediaPlayer::GetDecoderTime() const
+{
+	if (!IsMediaOpen())
+	{
+		return FTimespan::Zero();
+	}
+
+	const int64 Time = FVlc::MediaPlayerGetTime(Player);
+
+	return (Time > 0) ? FTimespan(Time * ETimespan::TicksPerMillisecond) : FTimespan::Zero();
+}
+
+
+void FVlcMediaPlayer::GetTimingRows(TArray<FString>& OutRows) const
+{
+	TArray<TPair<const TCHAR*, const FVlcMediaHistogram*>> Timings;
+	GetTimings(Timings);
+
+	const FString Url = MediaSource.GetCurrentUrl();
+
+	for (const auto& Timing : Timings)
+	{
+		OutRows.Add(FString::Printf(TEXT("\"%s\",%s,%s"), *Url, Timing.Key, *Timing.Value->ToCsv()));
+	}
+}
+
+
+void FVlcMediaPlayer::ReleaseClock()
+{
+	ExternalClock = false;
+	SetRateCorrection(1.0f);
+}
+
+
+void FVlcMediaPlayer::SetClockTime(FTimespan Time)
+{
+	StopSeekCatchUp(true);
+
+	ExternalClock = true;
+	CurrentTime = Timeshift.IsActive() ? Timeshift.GetWindowStart() + Time : Time;
+}
+
+
+bool FVlcMediaPlayer::SetRateCorrection(float Factor)
+{
+	if (Factor == RateCorrection)
+	{
+		return true;
+	}
+
+	RateCorrection = Factor;
+	StopSeekCatchUp(true);
+
+	if (!IsMediaOpen() || (CurrentRate == 0.0f))
+	{
+		return true; // applied when playback starts
+	}
+
+	return (FVlc::MediaPlayerSetRate(Player, CurrentRate * RateCorrection) != -1);
 }
 
 
@@ -36,7 +154,7 @@ FVlcMediaPlayer::~FVlcMediaPlayer()
 
 bool FVlcMediaPlayer::CanControl(EMediaControl Control) const
 {
-	if (Player == nullptr)
+	if (!IsMediaOpen())
 	{
 		return false;
 	}
@@ -48,12 +166,17 @@ bool FVlcMediaPlayer::CanControl(EMediaControl Control) const
 
 	if (Control == EMediaControl::Resume)
 	{
+		if (Reverse.IsActive())
+		{
+			return (CurrentRate == 0.0f);
+		}
+
 		return (FVlc::MediaPlayerGetState(Player) != ELibvlcState::Playing);
 	}
 
 	if ((Control == EMediaControl::Scrub) || (Control == EMediaControl::Seek))
 	{
-		return (FVlc::MediaPlayerIsSeekable(Player) != 0);
+		return Timeshift.IsActive() || (FVlc::MediaPlayerIsSeekable(Player) != 0);
 	}
 
 	return false;
@@ -62,6 +185,11 @@ bool FVlcMediaPlayer::CanControl(EMediaControl Control) const
 
 FTimespan FVlcMediaPlayer::GetDuration() const
 {
+	if (Timeshift.IsActive())
+	{
+		return Timeshift.GetWindow();
+	}
+
 	return MediaSource.GetDuration();
 }
 
@@ -74,11 +202,16 @@ float FVlcMediaPlayer::GetRate() const
 
 EMediaState FVlcMediaPlayer::GetState() const
 {
-	if (Player == nullptr)
+	if (!IsMediaOpen())
 	{
 		return EMediaState::Closed;
 	}
 
+	if (Reverse.IsActive())
+	{
+		return (CurrentRate != 0.0f) ? EMediaState::Playing : EMediaState::Paused;
+	}
+
 	ELibvlcState State = FVlc::MediaPlayerGetState(Player);
 
 	switch (State)
@@ -108,7 +241,13 @@ EMediaState FVlcMediaPlayer::GetState() const
 
 EMediaStatus FVlcMediaPlayer::GetStatus() const
 {
-	return (GetState() == EMediaState::Preparing) ? EMediaStatus::Buffering : EMediaStatus::None;
+	if (GetState() == EMediaState::Preparing)
+	{
+		return EMediaStatus::Buffering;
+	}
+
+	// VLC keeps playing while it refills its input buffer after seeking
+	return (!Reverse.IsActive() && (BufferingProgress < 100.0f)) ? EMediaStatus::Buffering : EMediaStatus::None;
 }
 
 
@@ -118,19 +257,39 @@ TRangeSet<float> FVlcMediaPlayer::GetSupportedRates(EMediaRateThinning Thinning)
 
 	if (Thinning == EMediaRateThinning::Thinned)
 	{
-		Result.Add(TRange<float>::Inclusive(0.0f, 10.0f));
+		Result.Add(TRange<float>::Inclusive(0.0f, VlcMediaPlayer::MaxThinnedRate));
+	}
+	else if (Timeshift.IsActive())
+	{
+		Result.Add(TRange<float>::Inclusive(0.0f, 2.0f)); // catch up with the live stream
 	}
 	else
 	{
 		Result.Add(TRange<float>::Inclusive(0.0f, 1.0f));
 	}
 
+	if (CanReverse())
+	{
+		Result.Add(TRange<float>::Inclusive(-VlcMediaPlayer::MaxReverseRate, 0.0f));
+	}
+
 	return Result;
 }
 
 
 FTimespan FVlcMediaPlayer::GetTime() const
 {
+	if (Timeshift.IsActive())
+	{
+		// the current time counts from the start of the recording, but the duration is only the window
+		return FMath::Max(FTimespan::Zero(), CurrentTime - Timeshift.GetWindowStart());
+	}
+
+	if (SeekTarget > FTimespan::Zero())
+	{
+		return SeekTarget; // still decoding towards it
+	}
+
 	return CurrentTime;
 }
 
@@ -143,6 +302,11 @@ bool FVlcMediaPlayer::IsLooping() const
 
 bool FVlcMediaPlayer::Seek(const FTimespan& Time)
 {
+	if (!IsMediaOpen())
+	{
+		return false;
+	}
+
 	ELibvlcState State = FVlc::MediaPlayerGetState(Player);
 
 	if ((State == ELibvlcState::Opening) ||
@@ -152,7 +316,60 @@ bool FVlcMediaPlayer::Seek(const FTimespan& Time)
 		return false;
 	}
 
-	if (Time != CurrentTime)
+	if (Time == GetTime())
+	{
+		return true;
+	}
+
+	// a new seek replaces the one that may still be decoding towards its target
+	StopSeekCatchUp(false);
+
+	if (Reverse.IsActive())
+	{
+		// the reverse playback cache decodes the new time on the next tick
+		const FTimespan Duration = GetDuration();
+		CurrentTime = FMath::Clamp(Time, FTimespan::Zero(), (Duration > FTimespan::Zero()) ? Duration : Time);
+
+		return true;
+	}
+
+	if (RestartTime > FTimespan::Zero())
+	{
+		// media was restarted while paused, so there is nothing to seek yet
+		RestartTime = Timeshift.IsActive() ? Timeshift.GetWindowStart() + Time : Time;
+		CurrentTime = RestartTime;
+
+		return true;
+	}
+
+	FVlcMediaKeyframe Keyframe;
+
+	if (Timeshift.IsActive())
+	{
+		if (Timeshift.GetWindow() <= FTimespan::Zero())
+		{
+			return false;
+		}
+
+		SeekTimeshift(Timeshift.GetWindowStart() + Time);
+	}
+	else if (IndexedSeeking && !ExternalClock && (State == ELibvlcState::Playing) && KeyframeIndex.FindKeyframe(Time, Keyframe))
+	{
+		// with ts-seek-percent, positions are byte offsets, so VLC jumps straight to the key frame
+		FVlc::MediaPlayerSetPosition(Player, KeyframeIndex.GetPosition(Keyframe));
+		CurrentTime = Keyframe.Time;
+
+		if (Keyframe.Time < Time)
+		{
+			// decode the frames up to the requested time faster and drop them (see TickInput)
+			SeekResumeRate = FVlc::MediaPlayerGetRate(Player);
+			SeekTarget = Time;
+
+			FVlc::MediaPlayerSetRate(Player, SeekResumeRate * VlcMediaPlayer::SeekCatchUpFactor);
+			Callbacks.SetDiscardTime(Time);
+		}
+	}
+	else
 	{
 		FVlc::MediaPlayerSetTime(Player, Time.GetTotalMilliseconds());
 		CurrentTime = Time;
@@ -171,12 +388,47 @@ bool FVlcMediaPlayer::SetLooping(bool Looping)
 
 bool FVlcMediaPlayer::SetRate(float Rate)
 {
-	if (Player == nullptr)
+	if (!IsMediaOpen())
 	{
 		return false;
 	}
 
-	if ((FVlc::MediaPlayerSetRate(Player, Rate) == -1))
+	StopSeekCatchUp(true);
+
+	if (Rate < 0.0f)
+	{
+		if (!Reverse.IsActive() && !StartReverse())
+		{
+			return false;
+		}
+
+		CurrentRate = Rate;
+		EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackResumed);
+
+		return true;
+	}
+
+	if (Reverse.IsActive())
+	{
+		if (Rate == 0.0f)
+		{
+			// keep the decoded frames around in case playback continues in reverse
+			CurrentRate = 0.0f;
+			EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackSuspended);
+
+			return true;
+		}
+
+		StopReverse();
+	}
+
+	// switch between decoding all frames and key frames only (keep the decoder setup when pausing)
+	if ((Rate != 0.0f) && (GetSkipFrames(Rate) != SkipFrames))
+	{
+		return RestartMedia(Rate);
+	}
+
+	if ((FVlc::MediaPlayerSetRate(Player, Rate * RateCorrection) == -1))
 	{
 		return false;
 	}
@@ -210,26 +462,50 @@ bool FVlcMediaPlayer::SetRate(float Rate)
 
 void FVlcMediaPlayer::Close()
 {
-	if (Player == nullptr)
+	if (!IsMediaOpen())
 	{
+		// may still be waiting for the first time-shift segments
+		Timeshift.Stop();
+		TimeshiftUrl.Reset();
+
 		return;
 	}
 
-	// detach callback handlers
-	Callbacks.Shutdown();
+	StopSeekCatchUp(false);
+
+	IndexedSeeking = false;
+	KeyframeIndex.Reset();
 	Tracks.Shutdown();
 	View.Shutdown();
 
-	// release player
+	// stop playback, but keep the player (and its outputs) around for reuse
 	FVlc::MediaPlayerStop(Player);
-	FVlc::MediaPlayerRelease(Player);
-	Player = nullptr;
+	FVlc::MediaPlayerSetMedia(Player, nullptr);
+	Recording.Stop();
+	Reverse.Stop();
+	ReverseSample.Reset();
+
+	// discard pending events & samples from the previous media
+	Events.Empty();
+	Callbacks.Reset();
 
 	// reset fields
+	BufferingProgress = 100.0f;
 	CurrentRate = 0.0f;
 	CurrentTime = FTimespan::Zero();
+	DemuxExtension.Reset();
+	DemuxHint.Reset();
+	FailedDemuxHint.Reset();
+	LowLatencyCaching = FTimespan::Zero();
+	MediaFilePath.Reset();
 	MediaSource.Close();
-	Info.Empty();
+	PlayedTime = FTimespan::Zero();
+	RestartTime = FTimespan::Zero();
+	Stats.Reset();
+	StepPending = false;
+	Subtitles.Reset();
+	Timeshift.Stop();
+	TimeshiftUrl.Reset();
 
 	// notify listeners
 	EventSink.ReceiveMediaEvent(EMediaEvent::TracksChanged);
@@ -251,7 +527,7 @@ IMediaControls& FVlcMediaPlayer::GetControls()
 
 FString FVlcMediaPlayer::GetInfo() const
 {
-	return Info;
+	return Tracks.GetInfo();
 }
 
 
@@ -270,20 +546,11 @@ IMediaSamples& FVlcMediaPlayer::GetSamples()
 
 FString FVlcMediaPlayer::GetStats() const
 {
-	FLibvlcMedia* Media = MediaSource.GetMedia();
-
-	if (Media == nullptr)
+	if (!IsMediaOpen())
 	{
 		return TEXT("No media opened.");
 	}
 
-	FLibvlcMediaStats Stats;
-	
-	if (!FVlc::MediaGetStats(Media, &Stats))
-	{
-		return TEXT("Stats currently not available.");
-	}
-
 	FString StatsString;
 	{
 		StatsString += TEXT("General\n");
@@ -291,18 +558,22 @@ FString FVlcMediaPlayer::GetStats() const
 		StatsString += FString::Printf(TEXT("    Decoded Audio: %i\n"), Stats.DecodedAudio);
 		StatsString += FString::Printf(TEXT("    Displayed Pictures: %i\n"), Stats.DisplayedPictures);
 		StatsString += FString::Printf(TEXT("    Lost Pictures: %i\n"), Stats.LostPictures);
-		StatsString += FString::Printf(TEXT("    Played A-Buffers: %i\n"), Stats.PlayedAbuffers);
-		StatsString += FString::Printf(TEXT("    Lost Lost A-Buffers: %i\n"), Stats.LostAbuffers);
+		StatsString += FString::Printf(TEXT("    Played A-Buffers: %i\n"), Stats.PlayedAudioBuffers);
+		StatsString += FString::Printf(TEXT("    Lost A-Buffers: %i\n"), Stats.LostAudioBuffers);
+		StatsString += FString::Printf(TEXT("    Coalesced Events: %i\n"), Events.GetNumCoalesced());
+		StatsString += FString::Printf(TEXT("    Decoded Streams: %s\n"), (DecodeAudio && DecodeVideo) ? TEXT("audio, video") : DecodeAudio ? TEXT("audio") : DecodeVideo ? TEXT("video") : TEXT("none"));
+		StatsString += FString::Printf(TEXT("    Decoder Skipping: %s\n"), (SkipFrames == EVlcMediaSkipFrames::NonKey) ? TEXT("non-key frames") : (SkipFrames == EVlcMediaSkipFrames::BFrames) ? TEXT("B-frames") : TEXT("none"));
 		StatsString += TEXT("\n");
 
 		StatsString += TEXT("Input\n");
-		StatsString += FString::Printf(TEXT("    Bit Rate: %i\n"), Stats.InputBitrate);
-		StatsString += FString::Printf(TEXT("    Bytes Read: %i\n"), Stats.ReadBytes);
+		StatsString += FString::Printf(TEXT("    Access: %s\n"), MediaSource.IsPath() ? TEXT("file path") : MediaSource.IsArchive() ? TEXT("archive") : TEXT("URL"));
+		StatsString += FString::Printf(TEXT("    Bit Rate: %f\n"), Stats.InputBitrate);
+		StatsString += FString::Printf(TEXT("    Bytes Read: %lld\n"), Stats.InputBytesRead);
 		StatsString += TEXT("\n");
 
 		StatsString += TEXT("Demux\n");
 		StatsString += FString::Printf(TEXT("    Bit Rate: %f\n"), Stats.DemuxBitrate);
-		StatsString += FString::Printf(TEXT("    Bytes Read: %i\n"), Stats.DemuxReadBytes);
+		StatsString += FString::Printf(TEXT("    Bytes Read: %lld\n"), Stats.DemuxBytesRead);
 		StatsString += FString::Printf(TEXT("    Corrupted: %i\n"), Stats.DemuxCorrupted);
 		StatsString += FString::Printf(TEXT("    Discontinuity: %i\n"), Stats.DemuxDiscontinuity);
 		StatsString += TEXT("\n");
@@ -312,6 +583,80 @@ FString FVlcMediaPlayer::GetStats() const
 		StatsString += FString::Printf(TEXT("    Sent Bytes: %i\n"), Stats.SentBytes);
 		StatsString += FString::Printf(TEXT("    Sent Packets: %i\n"), Stats.SentPackets);
 		StatsString += TEXT("\n");
+
+		StatsString += TEXT("Samples\n");
+		StatsString += FString::Printf(TEXT("    Audio Queue: %i\n"), Stats.AudioSampleQueue);
+		StatsString += FString::Printf(TEXT("    Video Queue: %i\n"), Stats.VideoSampleQueue);
+		StatsString += FString::Printf(TEXT("    Audio Pool: %i\n"), Stats.AudioSamplePool);
+		StatsString += FString::Printf(TEXT("    Video Pool: %i\n"), Stats.VideoSamplePool);
+		StatsString += FString::Printf(TEXT("    Duplicate Video: %i\n"), Stats.DuplicateVideoSamples);
+		StatsString += TEXT("\n");
+
+		if (LowLatencyCaching > FTimespan::Zero())
+		{
+			// streams carry no capture times, so estimate from caching and time spent in the pipeline
+			// (the lock to fetch time already includes decoding and queuing)
+			const FVlcMediaSampleLatencies& Latencies = Callbacks.GetLatencies();
+			const int64 MedianMicroseconds = (int64)(LowLatencyCaching.GetTotalMicroseconds()) + Latencies.VideoTotal.GetPercentile(0.5f);
+
+			StatsString += TEXT("Low Latency\n");
+			StatsString += FString::Printf(TEXT("    Caching: %i ms\n"), (int32)LowLatencyCaching.GetTotalMilliseconds());
+			StatsString += FString::Printf(TEXT("    Skipped Frames: %i\n"), Stats.SkippedVideoSamples);
+			StatsString += FString::Printf(TEXT("    Estimated Latency (median): %.1f ms\n"), MedianMicroseconds / 1000.0);
+			StatsString += TEXT("\n");
+		}
+
+		if (DeliveryRate > 0.0f)
+		{
+			// the decoder doesn't count skipped frames, so compare with the frames in the played time instead
+			const float SourceFrames = (float)PlayedTime.GetTotalSeconds() * FVlc::MediaPlayerGetFps(Player);
+
+			StatsString += TEXT("Decimation\n");
+			StatsString += FString::Printf(TEXT("    Delivery Rate: %.1f fps\n"), DeliveryRate);
+			StatsString += FString::Printf(TEXT("    Source Frames (est.): %i\n"), (int32)SourceFrames);
+			StatsString += FString::Printf(TEXT("    Not Delivered: %i\n"), Stats.DecimatedVideoSamples);
+
+			// without LibVLC's statistics, the decoded frame counter stays at zero
+			if (GetDefault<UVlcMediaSettings>()->CollectStats)
+			{
+				const float DecodeSavings = (SourceFrames > 0.0f) ? FMath::Max(0.0f, 1.0f - Stats.DecodedVideo / SourceFrames) : 0.0f;
+
+				StatsString += FString::Printf(TEXT("    Decoded Frames: %i\n"), Stats.DecodedVideo);
+				StatsString += FString::Printf(TEXT("    Decode Work Saved (est.): %.0f%%\n"), DecodeSavings * 100.0f);
+			}
+			else
+			{
+				StatsString += TEXT("    Decode Work Saved: unknown (enable CollectStats)\n");
+			}
+
+			StatsString += TEXT("\n");
+		}
+
+		if (Reverse.IsActive())
+		{
+			StatsString += TEXT("Reverse\n");
+			StatsString += Reverse.GetStats();
+			StatsString += TEXT("\n");
+		}
+
+		if (Recording.IsActive())
+		{
+			StatsString += TEXT("Recording\n");
+			StatsString += Recording.GetStats();
+			StatsString += TEXT("\n");
+		}
+
+		TArray<TPair<const TCHAR*, const FVlcMediaHistogram*>> Timings;
+		GetTimings(Timings);
+
+		StatsString += TEXT("Timings\n");
+
+		for (const auto& Timing : Timings)
+		{
+			StatsString += FString::Printf(TEXT("    %s: %s\n"), Timing.Key, *Timing.Value->ToString());
+		}
+
+		StatsString += TEXT("\n");
 	}
 
 	return StatsString;
@@ -326,6 +671,11 @@ IMediaTracks& FVlcMediaPlayer::GetTracks()
 
 FString FVlcMediaPlayer::GetUrl() const
 {
+	if (Timeshift.IsActive())
+	{
+		return TimeshiftUrl;
+	}
+
 	return MediaSource.GetCurrentUrl();
 }
 
@@ -339,48 +689,80 @@ IMediaView& FVlcMediaPlayer::GetView()
 bool FVlcMediaPlayer::Open(const FString& Url, const IMediaOptions* Options)
 {
 	Close();
+	MediaFilePath.Reset();
+	ConfigureOutput(Options);
 
 	if (Url.IsEmpty())
 	{
 		return false;
 	}
 
+	const auto Settings = GetDefault<UVlcMediaSettings>();
+	const bool UseTimeshift = FVlcMediaTimeshift::IsLiveUrl(Url) && ((Options != nullptr) ? Options->GetMediaOption("Timeshift", Settings->TimeshiftLive) : Settings->TimeshiftLive);
+
 	if (Url.StartsWith(TEXT("file://")))
 	{
-		// open local files via platform file system
-		TSharedPtr<FArchive, ESPMode::ThreadSafe> Archive;
 		const TCHAR* FilePath = &Url[7];
+		const bool PrecacheFile = (Options != nullptr) && Options->GetMediaOption("PrecacheFile", false);
+		const bool NativeFileAccess = !PrecacheFile && ((Options != nullptr) ? Options->GetMediaOption("NativeFileAccess", Settings->NativeFileAccess) : Settings->NativeFileAccess);
 
-		if ((Options != nullptr) && Options->GetMediaOption("PrecacheFile", false))
+		// let VLC read plain files itself, and stream all others via platform file system
+		if (!NativeFileAccess || !MediaSource.OpenPath(FilePath, Url))
 		{
-			FArrayReader* Reader = new FArrayReader;
+			TSharedPtr<FArchive, ESPMode::ThreadSafe> Archive;
 
-			if (FFileHelper::LoadFileToArray(*Reader, FilePath))
+			if (PrecacheFile)
 			{
-				Archive = MakeShareable(Reader);
+				FArrayReader* Reader = new FArrayReader;
+
+				if (FFileHelper::LoadFileToArray(*Reader, FilePath))
+				{
+					Archive = MakeShareable(Reader);
+				}
+				else
+				{
+					delete Reader;
+				}
 			}
 			else
 			{
-				delete Reader;
+				Archive = MakeShareable(IFileManager::Get().CreateFileReader(FilePath));
 			}
-		}
-		else
-		{
-			Archive = MakeShareable(IFileManager::Get().CreateFileReader(FilePath));
-		}
 
-		if (!Archive.IsValid())
-		{
-			UE_LOG(LogVlcMedia, Warning, TEXT("Failed to open media file: %s"), FilePath);
-			return false;
+			if (!Archive.IsValid())
+			{
+				UE_LOG(LogVlcMedia, Warning, TEXT("Failed to open media file: %s"), FilePath);
+				return false;
+			}
+
+			if (!MediaSource.OpenArchive(Archive.ToSharedRef(), Url))
+			{
+				return false;
+			}
+
+			ConfigureDemuxHint(Url);
 		}
 
-		if (!MediaSource.OpenArchive(Archive.ToSharedRef(), Url))
+		MediaFilePath = FilePath;
+		LoadSubtitles();
+	}
+	else if (UseTimeshift)
+	{
+		if (!Timeshift.Start(VlcInstance, Url, Settings->TimeshiftWindow))
 		{
 			return false;
 		}
+
+		// playback starts once the first segments were recorded (see TickInput)
+		TimeshiftUrl = Url;
+
+		return true;
 	}
-	else if (!MediaSource.OpenUrl(Url))
+	else if (MediaSource.OpenUrl(Url))
+	{
+		ConfigureLowLatency(Url, Options);
+	}
+	else
 	{
 		return false;
 	}
@@ -389,40 +771,130 @@ bool FVlcMediaPlayer::Open(const FString& Url, const IMediaOptions* Options)
 }
 
 
-bool FVlcMediaPlayer::Open(const TSharedRef<FArchive, ESPMode::ThreadSafe>& Archive, const FString& OriginalUrl, const IMediaOptions* /*Options*/)
+bool FVlcMediaPlayer::Open(const TSharedRef<FArchive, ESPMode::ThreadSafe>& Archive, const FString& OriginalUrl, const IMediaOptions* Options)
 {
 	Close();
+	MediaFilePath.Reset();
+	ConfigureOutput(Options);
 
 	if (OriginalUrl.IsEmpty() || !MediaSource.OpenArchive(Archive, OriginalUrl))
 	{
 		return false;
 	}
-	
+
+	ConfigureDemuxHint(OriginalUrl);
+
+	if (OriginalUrl.StartsWith(TEXT("file://")))
+	{
+		MediaFilePath = OriginalUrl.RightChop(7);
+		LoadSubtitles();
+	}
+
 	return InitializePlayer();
 }
 
 
 void FVlcMediaPlayer::TickInput(FTimespan DeltaTime, FTimespan /*Timecode*/)
 {
-	if (Player == nullptr)
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_TickInput);
+	CSV_SCOPED_TIMING_STAT(VlcMedia, TickInput);
+
+	if (Timeshift.IsActive())
+	{
+		Timeshift.Update();
+
+		// start playing the time-shift buffer once it has content
+		if (!IsMediaOpen() && Timeshift.IsReady())
+		{
+			if (!MediaSource.OpenUrl(Timeshift.GetPlaylistUrl()) || !InitializePlayer())
+			{
+				Timeshift.Stop();
+				TimeshiftUrl.Reset();
+				EventSink.ReceiveMediaEvent(EMediaEvent::MediaOpenFailed);
+
+				return;
+			}
+		}
+	}
+
+	if (!IsMediaOpen())
 	{
 		return;
 	}
 
 	// process events
-	ELibvlcEventType Event;
+	FLibvlcEvent Event;
 
 	while (Events.Dequeue(Event))
 	{
-		switch (Event)
+		switch (Event.Type)
 		{
 		case ELibvlcEventType::MediaParsedChanged:
-			Tracks.Initialize(*Player, Info);
-			Callbacks.Initialize(*Player);
-			View.Initialize(*Player);
+			if (Tracks.IsInitialized())
+			{
+				Tracks.UpdateFormats();
+			}
+			else
+			{
+				Tracks.Initialize(*Player, MediaSource.GetMedia(), Subtitles);
+				View.Initialize(*Player);
+			}
+
+			if ((ProbeIndex != nullptr) && !MediaFilePath.IsEmpty())
+			{
+				FVlcMediaInfo Info;
+				Tracks.GetMediaInfo(Info);
+				Info.Duration = MediaSource.GetDuration();
+
+				// the probe index reads the interval from the container if the key frame index has none
+				if (Info.VideoTracks.Num() > 0)
+				{
+					Info.VideoTracks[0].KeyframeInterval = KeyframeIndex.GetAverageInterval();
+				}
+
+				ProbeIndex->Add(MediaFilePath, Info);
+			}
+
+			if (DecodeVideo)
+			{
+				FMediaVideoTrackFormat VideoFormat;
+
+				if (Tracks.GetVideoTrackFormat(0, 0, VideoFormat))
+				{
+					Callbacks.PrewarmVideoSamples(VideoFormat.Dim);
+
+					// decoder options only apply when the media starts, so restart once when the video size becomes known
+					if ((DecoderScaledDim == FIntPoint::ZeroValue) && ConfigureDecoderScaling(VideoFormat.Dim))
+					{
+						const ELibvlcState State = FVlc::MediaPlayerGetState(Player);
+						const bool Running = (State == ELibvlcState::Opening) || (State == ELibvlcState::Buffering) || (State == ELibvlcState::Playing);
+
+						RestartMedia(Running ? FVlc::MediaPlayerGetRate(Player) / RateCorrection : 0.0f);
+					}
+				}
+			}
+
 			EventSink.ReceiveMediaEvent(EMediaEvent::TracksChanged);
 			break;
 
+		case ELibvlcEventType::MediaPlayerESAdded:
+			if (Tracks.AddTrack(Event.Descriptor.MediaPlayerESChanged.Type, Event.Descriptor.MediaPlayerESChanged.Id))
+			{
+				EventSink.ReceiveMediaEvent(EMediaEvent::TracksChanged);
+			}
+			break;
+
+		case ELibvlcEventType::MediaPlayerESDeleted:
+			if (Tracks.RemoveTrack(Event.Descriptor.MediaPlayerESChanged.Type, Event.Descriptor.MediaPlayerESChanged.Id))
+			{
+				EventSink.ReceiveMediaEvent(EMediaEvent::TracksChanged);
+			}
+			break;
+
+		case ELibvlcEventType::MediaPlayerBuffering:
+			BufferingProgress = Event.Descriptor.MediaPlayerBuffering.NewCache;
+			break;
+
 		case ELibvlcEventType::MediaPlayerEndReached:
 			// begin hack: this causes a short delay, but there seems to be no
 			// other way. looping via VLC Media List players is also broken :(
@@ -444,10 +916,39 @@ void FVlcMediaPlayer::TickInput(FTimespan DeltaTime, FTimespan /*Timecode*/)
 			break;
 
 		case ELibvlcEventType::MediaPlayerPaused:
-			EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackSuspended);
+			if (!Reverse.IsActive()) // the reverse playback cache pauses VLC while it delivers frames
+			{
+				EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackSuspended);
+			}
 			break;
 
 		case ELibvlcEventType::MediaPlayerPlaying:
+			if (!DemuxHint.IsEmpty() && !DemuxHintConfirmed)
+			{
+				DemuxHints->ReportResult(DemuxExtension, DemuxHint, true);
+				DemuxHintConfirmed = true;
+			}
+			else if (!FailedDemuxHint.IsEmpty())
+			{
+				// VLC's probing opened the media that the forced demuxer couldn't open
+				DemuxHints->ReportResult(DemuxExtension, FailedDemuxHint, false);
+				FailedDemuxHint.Reset();
+			}
+
+			if (RestartTime > FTimespan::Zero())
+			{
+				if (Timeshift.IsActive())
+				{
+					SeekTimeshift(RestartTime);
+				}
+				else
+				{
+					FVlc::MediaPlayerSetTime(Player, RestartTime.GetTotalMilliseconds());
+				}
+
+				RestartTime = FTimespan::Zero();
+			}
+
 			EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackResumed);
 			break;
 
@@ -458,40 +959,243 @@ void FVlcMediaPlayer::TickInput(FTimespan DeltaTime, FTimespan /*Timecode*/)
 
 	const ELibvlcState State = FVlc::MediaPlayerGetState(Player);
 
-	// update current time & rate
-	if (State == ELibvlcState::Playing)
+	if ((State == ELibvlcState::Error) && !DemuxHint.IsEmpty() && !DemuxHintConfirmed)
 	{
-		CurrentRate = FVlc::MediaPlayerGetRate(Player);
-		CurrentTime += DeltaTime * CurrentRate;
+		// the forced demuxer couldn't open the media, which may also be corrupt, so let VLC probe it to find out
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Player %p: The %s demuxer failed, probing instead"), this, *DemuxHint);
+
+		FailedDemuxHint = DemuxHint;
+		DemuxHint.Reset();
+		RestartMedia(FVlc::MediaPlayerGetRate(Player) / RateCorrection);
+
+		return;
 	}
-	else
+
+	// update current time & rate
+	if (Reverse.IsActive())
 	{
-		CurrentRate = 0.0f;
+		TickReverse(DeltaTime);
 	}
+	else if (State == ELibvlcState::Playing)
+	{
+		CurrentRate = FVlc::MediaPlayerGetRate(Player) / RateCorrection;
 
-	Callbacks.SetCurrentTime(CurrentTime);
+		if (SeekTarget > FTimespan::Zero())
+		{
+			// VLC plays faster while decoding towards the target of an indexed seek
+			CurrentTime += DeltaTime * CurrentRate;
+			CurrentRate = SeekResumeRate / RateCorrection;
+
+			if (CurrentTime >= SeekTarget)
+			{
+				StopSeekCatchUp(false);
+			}
+		}
+		else if (!ExternalClock)
+		{
+			CurrentTime += DeltaTime * CurrentRate;
+		}
+
+		PlayedTime += DeltaTime * CurrentRate;
+
+		// stop catching up when reaching the live stream
+		if (Timeshift.IsActive() && (CurrentRate > 1.0f) && Timeshift.IsAtLiveEdge(CurrentTime))
+		{
+			SetRate(1.0f);
+		}
+	}
+	else
+	{
+		CurrentRate = 0.0f;
+
+		// no further frame may follow the one that is held back to detect duplicates
+		Callbacks.FlushHeldVideoSample();
+	}
+
+	Callbacks.SetCurrentTime(CurrentTime);
+	Subtitles.Tick(CurrentTime, Callbacks.GetSamples());
+
+	UpdateStats();
+}
+
+
+/* IVlcMediaPlayer interface
+ *****************************************************************************/
+
+float FVlcMediaPlayer::GetDeliveryRate() const
+{
+	return DeliveryRate;
+}
+
+
+bool FVlcMediaPlayer::IsDecodingAudio() const
+{
+	return DecodeAudio;
+}
+
+
+bool FVlcMediaPlayer::IsDecodingVideo() const
+{
+	return DecodeVideo;
+}
+
+
+bool FVlcMediaPlayer::IsRecording() const
+{
+	return Recording.IsActive();
+}
+
+
+bool FVlcMediaPlayer::IsStepPending() const
+{
+	return StepPending;
+}
+
+
+bool FVlcMediaPlayer::SetDecodeStreams(bool Audio, bool Video)
+{
+	if ((Audio == DecodeAudio) && (Video == DecodeVideo))
+	{
+		return true;
+	}
+
+	DecodeAudio = Audio;
+	DecodeVideo = Video;
+
+	// VLC only creates decoders when the media starts
+	if (IsMediaOpen())
+	{
+		return RestartMedia(CurrentRate);
+	}
+
+	return true;
+}
+
+
+bool FVlcMediaPlayer::SetDeliveryRate(float FramesPerSecond)
+{
+	DeliveryRate = FMath::Max(0.0f, FramesPerSecond);
+	Callbacks.SetDeliveryInterval((DeliveryRate > 0.0f) ? FTimespan::FromSeconds(1.0 / DeliveryRate) : FTimespan::Zero());
+
+	// the decoder can only stop or start skipping frames when the media restarts
+	if (IsMediaOpen() && (GetSkipFrames(CurrentRate) != SkipFrames))
+	{
+		return RestartMedia(CurrentRate);
+	}
+
+	return true;
+}
+
+
+bool FVlcMediaPlayer::StartRecording(const FString& FilePath)
+{
+	if (!IsMediaOpen() || Recording.IsActive() || !Recording.Start(FilePath))
+	{
+		return false;
+	}
+
+	if (!RestartMedia(CurrentRate))
+	{
+		Recording.Stop();
+		return false;
+	}
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Player %p: Recording %s to %s"), this, *GetUrl(), *Recording.GetFilePath());
+
+	return true;
+}
+
+
+bool FVlcMediaPlayer::StepFrames(int32 NumFrames)
+{
+	if (!IsMediaOpen() || !CanReverse())
+	{
+		return false;
+	}
+
+	const float Fps = FVlc::MediaPlayerGetFps(Player);
+
+	if (Fps <= 0.0f)
+	{
+		return false;
+	}
+
+	// frames are delivered by the reverse playback cache, which is kept paused
+	if (!Reverse.IsActive() && !StartReverse())
+	{
+		return false;
+	}
+
+	if (CurrentRate != 0.0f)
+	{
+		CurrentRate = 0.0f;
+		EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackSuspended);
+	}
+
+	// step through the cached frames, so that the time lands on a decoded frame rather than between two
+	const FTimespan FrameDuration = FTimespan::FromSeconds(1.0 / Fps);
+	FTimespan TargetTime;
+
+	if (!Reverse.StepFrames(CurrentTime, NumFrames, FrameDuration, TargetTime))
+	{
+		// the target frame is decoded in the background, and the time snaps to it once it is available
+		const FTimespan Duration = GetDuration();
+		const FTimespan LastFrame = (Duration > FrameDuration) ? Duration - FrameDuration : FTimespan::MaxValue();
+
+		TargetTime = FMath::Clamp(TargetTime, FTimespan::Zero(), LastFrame);
+	}
+
+	CurrentTime = TargetTime;
+	StepPending = true;
+
+	// deliver right away if the frame is cached
+	TickReverse(FTimespan::Zero());
+
+	return true;
+}
+
+
+void FVlcMediaPlayer::StopRecording()
+{
+	if (!Recording.IsActive())
+	{
+		return;
+	}
+
+	// stopping the stream output finalizes the file
+	Recording.Stop();
+	RestartMedia(CurrentRate);
 }
 
 
 /* FVlcMediaPlayer implementation
  *****************************************************************************/
 
-bool FVlcMediaPlayer::InitializePlayer()
+bool FVlcMediaPlayer::CanReverse() const
 {
-	// create player for media source
-	Player = FVlc::MediaPlayerNewFromMedia(MediaSource.GetMedia());
+	// the media is decoded a second time, which requires a seekable file or URL
+	return IsMediaOpen() &&
+		!Timeshift.IsActive() &&
+		(LowLatencyCaching == FTimespan::Zero()) &&
+		(!MediaFilePath.IsEmpty() || !MediaSource.IsArchive()) &&
+		(FVlc::MediaPlayerIsSeekable(Player) != 0);
+}
+
+
+bool FVlcMediaPlayer::CreatePlayer()
+{
+	Player = FVlc::MediaPlayerNew(VlcInstance);
 
 	if (Player == nullptr)
 	{
-		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to initialize media player: %s"), ANSI_TO_TCHAR(FVlc::Errmsg()));
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to create media player: %s"), ANSI_TO_TCHAR(FVlc::Errmsg()));
 		return false;
 	}
 
-	// attach to event managers
-	FLibvlcEventManager* MediaEventManager = FVlc::MediaEventManager(MediaSource.GetMedia());
+	// attach to player events (these survive media changes)
 	FLibvlcEventManager* PlayerEventManager = FVlc::MediaPlayerEventManager(Player);
 
-	if ((MediaEventManager == nullptr) || (PlayerEventManager == nullptr))
+	if (PlayerEventManager == nullptr)
 	{
 		FVlc::MediaPlayerRelease(Player);
 		Player = nullptr;
@@ -499,11 +1203,156 @@ bool FVlcMediaPlayer::InitializePlayer()
 		return false;
 	}
 
-	FVlc::EventAttach(MediaEventManager, ELibvlcEventType::MediaParsedChanged, &FVlcMediaPlayer::StaticEventCallback, this);
+	// only attach to events that are handled in TickInput
+	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerBuffering, &FVlcMediaPlayer::StaticEventCallback, this);
 	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerEndReached, &FVlcMediaPlayer::StaticEventCallback, this);
+	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerESAdded, &FVlcMediaPlayer::StaticEventCallback, this);
+	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerESDeleted, &FVlcMediaPlayer::StaticEventCallback, this);
+	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerPaused, &FVlcMediaPlayer::StaticEventCallback, this);
 	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerPlaying, &FVlcMediaPlayer::StaticEventCallback, this);
-	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerPositionChanged, &FVlcMediaPlayer::StaticEventCallback, this);
-	FVlc::EventAttach(PlayerEventManager, ELibvlcEventType::MediaPlayerStopped, &FVlcMediaPlayer::StaticEventCallback, this);
+
+	// install output callbacks once, so that VLC can recycle its outputs
+	Callbacks.Initialize(*Player);
+
+	return true;
+}
+
+
+bool FVlcMediaPlayer::ConfigureDecoderScaling(const FIntPoint& SourceDim)
+{
+	const FIntPoint OutputDim = Callbacks.GetOutputDim(SourceDim);
+	const FIntPoint NewScaledDim = (OutputDim != SourceDim) ? SourceDim : FIntPoint::ZeroValue;
+
+	if (NewScaledDim == DecoderScaledDim)
+	{
+		return false;
+	}
+
+	DecoderScaledDim = NewScaledDim;
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Player %p: Scaling %ix%i video to %ix%i"), this, SourceDim.X, SourceDim.Y, OutputDim.X, OutputDim.Y);
+
+	return true;
+}
+
+
+void FVlcMediaPlayer::ConfigureDemuxHint(const FString& OriginalUrl)
+{
+	DemuxExtension = FPaths::GetExtension(OriginalUrl).ToLower();
+	DemuxHint = (DemuxHints != nullptr) ? DemuxHints->GetHint(DemuxExtension) : FString();
+	DemuxHintConfirmed = false;
+	FailedDemuxHint.Reset();
+
+	if (!DemuxHint.IsEmpty())
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Player %p: Using %s demuxer for %s"), this, *DemuxHint, *OriginalUrl);
+	}
+}
+
+
+void FVlcMediaPlayer::ConfigureOutput(const IMediaOptions* Options)
+{
+	if (Options == nullptr)
+	{
+		Callbacks.SetMaxOutputDim(0);
+		Callbacks.SetSkipDuplicateFrames(false);
+		SetDecodeStreams(true, true);
+		SetDeliveryRate(0.0f);
+
+		return;
+	}
+
+	Callbacks.SetMaxOutputDim((int32)Options->GetMediaOption("MaxOutputDim", (int64)0));
+	Callbacks.SetSkipDuplicateFrames(Options->GetMediaOption("SkipDuplicateFrames", false));
+	SetDecodeStreams(Options->GetMediaOption("DecodeAudio", true), Options->GetMediaOption("DecodeVideo", true));
+	SetDeliveryRate((float)Options->GetMediaOption("DeliveryRate", 0.0));
+}
+
+
+void FVlcMediaPlayer::ConfigureLowLatency(const FString& Url, const IMediaOptions* Options)
+{
+	FString Scheme;
+
+	if (!Url.Split(TEXT("://"), &Scheme, nullptr) || ((Scheme != TEXT("rtsp")) && (Scheme != TEXT("rtp")) && (Scheme != TEXT("udp"))))
+	{
+		return;
+	}
+
+	const auto Settings = GetDefault<UVlcMediaSettings>();
+	const bool LowLatency = (Options != nullptr) ? Options->GetMediaOption("LowLatency", Settings->LowLatencyLive) : Settings->LowLatencyLive;
+
+	if (!LowLatency)
+	{
+		return;
+	}
+
+	const int32 CachingMs = (int32)Settings->LowLatencyCaching.GetTotalMilliseconds();
+
+	MediaSource.AddOption(FString::Printf(TEXT(":network-caching=%i"), CachingMs));
+	MediaSource.AddOption(FString::Printf(TEXT(":live-caching=%i"), CachingMs));
+	MediaSource.AddOption(TEXT(":clock-jitter=0")); // don't buffer for jitter
+	MediaSource.AddOption(TEXT(":clock-synchro=0")); // don't pace to the sender's clock
+
+	LowLatencyCaching = Settings->LowLatencyCaching;
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Player %p: Using low-latency mode with %i ms caching for %s"), this, CachingMs, *Url);
+}
+
+
+bool FVlcMediaPlayer::InitializePlayer()
+{
+	// create player on first use only
+	if ((Player == nullptr) && !CreatePlayer())
+	{
+		MediaSource.Close();
+		return false;
+	}
+
+	// attach to media events
+	FLibvlcEventManager* MediaEventManager = FVlc::MediaEventManager(MediaSource.GetMedia());
+
+	if (MediaEventManager == nullptr)
+	{
+		MediaSource.Close();
+		return false;
+	}
+
+	FVlc::EventAttach(MediaEventManager, ELibvlcEventType::MediaParsedChanged, &FVlcMediaPlayer::StaticEventCallback, this);
+
+	Callbacks.GetSamples().SetLowLatency(LowLatencyCaching > FTimespan::Zero());
+
+	// index key frames of transport streams (cached indexes are available right away)
+	if (!MediaFilePath.IsEmpty() && GetDefault<UVlcMediaSettings>()->IndexKeyframes && FVlcMediaKeyframeIndex::IsSupported(MediaFilePath))
+	{
+		KeyframeIndex.Build(MediaFilePath);
+	}
+
+	IndexedSeeking = KeyframeIndex.IsAvailable();
+
+	// previously probed files can be scaled by the decoder right away (others restart once they were parsed)
+	FVlcMediaInfo ProbedInfo;
+	const bool Probed = (ProbeIndex != nullptr) && !MediaFilePath.IsEmpty() && ProbeIndex->Find(MediaFilePath, ProbedInfo);
+
+	DecoderScaledDim = FIntPoint::ZeroValue;
+
+	if (Probed && DecodeVideo && (ProbedInfo.VideoTracks.Num() > 0))
+	{
+		ConfigureDecoderScaling(ProbedInfo.VideoTracks[0].Dim);
+	}
+
+	// add options that may change while the media plays
+	TArray<FString> SwitchableOptions;
+	GetSwitchableOptions(0.0f, SwitchableOptions);
+
+	for (const FString& Option : SwitchableOptions)
+	{
+		MediaSource.AddOption(Option, false);
+	}
+
+	SkipFrames = GetSkipFrames(0.0f);
+
+	// retarget player to new media source
+	FVlc::MediaPlayerSetMedia(Player, MediaSource.GetMedia());
 
 	// initialize player
 	CurrentRate = 0.0f;
@@ -511,10 +1360,358 @@ bool FVlcMediaPlayer::InitializePlayer()
 
 	EventSink.ReceiveMediaEvent(EMediaEvent::MediaOpened);
 
+	// use previously probed tracks until VLC finished parsing the media
+	if (Probed)
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Player %p: Using probed media information for %s"), this, *MediaFilePath);
+
+		MediaSource.SetDuration(ProbedInfo.Duration);
+		Tracks.Initialize(*Player, MediaSource.GetMedia(), Subtitles, &ProbedInfo);
+		View.Initialize(*Player);
+
+		EventSink.ReceiveMediaEvent(EMediaEvent::TracksChanged);
+	}
+
+	return true;
+}
+
+
+void FVlcMediaPlayer::LoadSubtitles()
+{
+	if (Subtitles.Load(MediaFilePath) > 0)
+	{
+		return;
+	}
+
+	// subtitle autodetection is disabled globally, so VLC has to be told which files to read
+	const TArray<FString>& SlaveFiles = Subtitles.GetSlaveFiles();
+
+	if (SlaveFiles.Num() > 0)
+	{
+		MediaSource.AddOption(FString::Printf(TEXT(":input-slave=%s"), *FString::Join(SlaveFiles, TEXT("#"))));
+	}
+}
+
+
+void FVlcMediaPlayer::GetSwitchableOptions(float Rate, TArray<FString>& OutOptions) const
+{
+	if (!DemuxHint.IsEmpty())
+	{
+		OutOptions.Add(FString::Printf(TEXT(":demux=%s"), *DemuxHint));
+	}
+
+	// the TS demuxer treats positions as time fractions unless told otherwise
+	if (IndexedSeeking)
+	{
+		OutOptions.Add(TEXT(":ts-seek-percent"));
+	}
+
+	// unlike deselecting a track, this keeps VLC from creating the decoder at all
+	// (while recording, the stream output deselects them for display instead)
+	if (!DecodeAudio && !Recording.IsActive())
+	{
+		OutOptions.Add(TEXT(":no-audio"));
+	}
+
+	if (!DecodeVideo && !Recording.IsActive())
+	{
+		OutOptions.Add(TEXT(":no-video"));
+	}
+
+	// subtitle files replace VLC's subtitle streams
+	if ((Subtitles.GetNumTracks() > 0) && !Recording.IsActive())
+	{
+		OutOptions.Add(TEXT(":no-spu"));
+	}
+
+	if (DecoderScaledDim != FIntPoint::ZeroValue)
+	{
+		const FIntPoint OutputDim = Callbacks.GetOutputDim(DecoderScaledDim);
+
+		// decode at 1/2 or 1/4 size if the output is at least that much smaller (only some codecs support this)
+		int32 LowRes = 0;
+
+		while ((LowRes < 2) && ((DecoderScaledDim.GetMax() >> (LowRes + 1)) >= OutputDim.GetMax()))
+		{
+			++LowRes;
+		}
+
+		if (LowRes > 0)
+		{
+			OutOptions.Add(FString::Printf(TEXT(":avcodec-lowres=%i"), LowRes));
+		}
+
+		// deblocking artifacts of non-reference frames are hardly visible when downscaled
+		OutOptions.Add(TEXT(":avcodec-skiploopfilter=1"));
+	}
+
+	const EVlcMediaSkipFrames RateSkipFrames = GetSkipFrames(Rate);
+
+	if (RateSkipFrames != EVlcMediaSkipFrames::None)
+	{
+		OutOptions.Add(FString::Printf(TEXT(":avcodec-skip-frame=%i"), (int32)RateSkipFrames));
+	}
+}
+
+
+void FVlcMediaPlayer::GetTimings(TArray<TPair<const TCHAR*, const FVlcMediaHistogram*>>& OutTimings) const
+{
+	const FVlcMediaCallbackTimings& CallbackTimings = Callbacks.GetTimings();
+
+	OutTimings.Emplace(TEXT("AudioPlay"), &CallbackTimings.AudioPlay);
+	OutTimings.Emplace(TEXT("AudioSetup"), &CallbackTimings.AudioSetup);
+	OutTimings.Emplace(TEXT("AudioInterval"), &CallbackTimings.AudioInterval);
+	OutTimings.Emplace(TEXT("VideoLock"), &CallbackTimings.VideoLock);
+	OutTimings.Emplace(TEXT("VideoUnlock"), &CallbackTimings.VideoUnlock);
+	OutTimings.Emplace(TEXT("VideoDisplay"), &CallbackTimings.VideoDisplay);
+	OutTimings.Emplace(TEXT("VideoSetup"), &CallbackTimings.VideoSetup);
+	OutTimings.Emplace(TEXT("VideoInterval"), &CallbackTimings.VideoInterval);
+	OutTimings.Emplace(TEXT("MediaRead"), &MediaSource.GetReadTimes());
+	OutTimings.Emplace(TEXT("MediaSeek"), &MediaSource.GetSeekTimes());
+
+	const FVlcMediaSampleLatencies& Latencies = Callbacks.GetLatencies();
+
+	OutTimings.Emplace(TEXT("AudioQueueResidency"), &Latencies.AudioQueueResidency);
+	OutTimings.Emplace(TEXT("AudioPresentationLead"), &Latencies.AudioPresentationLead);
+	OutTimings.Emplace(TEXT("AudioPresentationLag"), &Latencies.AudioPresentationLag);
+	OutTimings.Emplace(TEXT("VideoDecodeToEnqueue"), &Latencies.VideoDecodeToEnqueue);
+	OutTimings.Emplace(TEXT("VideoQueueResidency"), &Latencies.VideoQueueResidency);
+	OutTimings.Emplace(TEXT("VideoTotal"), &Latencies.VideoTotal);
+}
+
+
+bool FVlcMediaPlayer::RestartMedia(float Rate)
+{
+	if (SeekTarget > FTimespan::Zero())
+	{
+		// continue at the requested time, and at the rate from before the seek rather than the faster one
+		Rate = (Rate != 0.0f) ? SeekResumeRate / RateCorrection : 0.0f;
+		StopSeekCatchUp(true);
+	}
+
+	// an index that finished building since the media was opened can be used from now on
+	IndexedSeeking = KeyframeIndex.IsAvailable();
+
+	TArray<FString> ExtraOptions;
+	GetSwitchableOptions(Rate, ExtraOptions);
+
+	FVlc::MediaPlayerStop(Player);
+
+	// the stream output reopens its file, so each restart continues the recording in a new one
+	if (Recording.IsActive())
+	{
+		ExtraOptions.Add(Recording.OpenOutput(DecodeAudio, DecodeVideo, Subtitles.GetNumTracks() == 0));
+		ExtraOptions.Add(TEXT(":sout-all")); // keep all elementary streams, not just the selected ones
+	}
+
+	if (!MediaSource.Reopen(ExtraOptions))
+	{
+		return false;
+	}
+
+	SkipFrames = GetSkipFrames(Rate);
+
+	// discard events & samples of the previous media object
+	Events.Empty();
+	Callbacks.Reset();
+	Stats.RestartMedia();
+
+	// tracks are initialized again once the new media object was parsed
+	Tracks.Shutdown();
+
+	FLibvlcEventManager* MediaEventManager = FVlc::MediaEventManager(MediaSource.GetMedia());
+
+	if (MediaEventManager != nullptr)
+	{
+		FVlc::EventAttach(MediaEventManager, ELibvlcEventType::MediaParsedChanged, &FVlcMediaPlayer::StaticEventCallback, this);
+	}
+
+	FVlc::MediaPlayerSetMedia(Player, MediaSource.GetMedia());
+	EventSink.ReceiveMediaEvent(EMediaEvent::TracksChanged);
+
+	// continue where playback left off
+	if (CurrentTime > FTimespan::Zero())
+	{
+		RestartTime = CurrentTime;
+	}
+
+	if (Rate != 0.0f)
+	{
+		return SetRate(Rate);
+	}
+
 	return true;
 }
 
 
+void FVlcMediaPlayer::SeekTimeshift(FTimespan Time)
+{
+	const FTimespan Window = Timeshift.GetWindow();
+	const FTimespan WindowStart = Timeshift.GetWindowStart();
+
+	if (Window <= FTimespan::Zero())
+	{
+		return;
+	}
+
+	const FTimespan WindowTime = FMath::Clamp(Time - WindowStart, FTimespan::Zero(), Window);
+
+	FVlc::MediaPlayerSetPosition(Player, (float)(WindowTime.GetTotalSeconds() / Window.GetTotalSeconds()));
+	CurrentTime = WindowStart + WindowTime;
+}
+
+
+bool FVlcMediaPlayer::StartReverse()
+{
+	const bool IsPath = !MediaFilePath.IsEmpty();
+	const FString Location = IsPath ? MediaFilePath : MediaSource.GetCurrentUrl();
+	const SIZE_T MaxCacheSize = (SIZE_T)FMath::Max(1, GetDefault<UVlcMediaSettings>()->ReverseCacheSize) * 1024 * 1024;
+
+	if (!Reverse.Start(VlcInstance, Location, IsPath, &KeyframeIndex, GetDuration(), Callbacks.GetMaxOutputDim(), MaxCacheSize))
+	{
+		return false;
+	}
+
+	// the VLC player holds its position while the reverse playback cache delivers frames
+	if (FVlc::MediaPlayerGetState(Player) == ELibvlcState::Playing)
+	{
+		FVlc::MediaPlayerSetPause(Player, 1);
+	}
+
+	Callbacks.GetSamples().FlushSamples();
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Player %p: Decoding %s in reverse from %s"), this, *Location, *CurrentTime.ToString());
+
+	return true;
+}
+
+
+void FVlcMediaPlayer::StopReverse()
+{
+	Reverse.Stop();
+	ReverseSample.Reset();
+	StepPending = false;
+
+	Callbacks.GetSamples().FlushSamples();
+
+	if (FVlc::MediaPlayerGetState(Player) == ELibvlcState::Paused)
+	{
+		FVlc::MediaPlayerSetTime(Player, CurrentTime.GetTotalMilliseconds());
+	}
+	else if (CurrentTime > FTimespan::Zero())
+	{
+		RestartTime = CurrentTime; // the media hasn't started yet
+	}
+}
+
+
+void FVlcMediaPlayer::StopSeekCatchUp(bool SeekPrecisely)
+{
+	if (SeekTarget == FTimespan::Zero())
+	{
+		return;
+	}
+
+	if (SeekPrecisely && (CurrentTime < SeekTarget))
+	{
+		// VLC decodes from the key frame before the target and drops the frames in between
+		FVlc::MediaPlayerSetTime(Player, SeekTarget.GetTotalMilliseconds());
+		CurrentTime = SeekTarget;
+	}
+
+	FVlc::MediaPlayerSetRate(Player, SeekResumeRate);
+	Callbacks.SetDiscardTime(FTimespan::Zero());
+	SeekTarget = FTimespan::Zero();
+}
+
+
+void FVlcMediaPlayer::TickReverse(FTimespan DeltaTime)
+{
+	FTimespan Time = CurrentTime;
+
+	if (!ExternalClock)
+	{
+		Time = FMath::Max(FTimespan::Zero(), Time + DeltaTime * CurrentRate);
+	}
+
+	Reverse.Tick(Time);
+
+	TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe> Sample;
+
+	if (!Reverse.FetchFrame(Time, Sample))
+	{
+		return; // hold the current frame until its GOP is decoded
+	}
+
+	CurrentTime = Time;
+
+	if (Sample.IsValid() && (Sample != ReverseSample))
+	{
+		Sample->SetEnqueueCycles(FPlatformTime::Cycles64());
+		Callbacks.GetSamples().AddVideo(Sample.ToSharedRef());
+		ReverseSample = Sample;
+	}
+
+	if (StepPending)
+	{
+		if (Sample.IsValid())
+		{
+			CurrentTime = Sample->GetTime(); // estimated step targets land on the actual frame
+		}
+
+		StepPending = false;
+		EventSink.ReceiveMediaEvent(EMediaEvent::SeekCompleted);
+	}
+
+	if ((CurrentTime == FTimespan::Zero()) && (CurrentRate < 0.0f))
+	{
+		EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackEndReached);
+
+		if (ShouldLoop)
+		{
+			CurrentTime = GetDuration();
+		}
+		else
+		{
+			CurrentRate = 0.0f;
+			EventSink.ReceiveMediaEvent(EMediaEvent::PlaybackSuspended);
+		}
+	}
+}
+
+
+EVlcMediaSkipFrames FVlcMediaPlayer::GetSkipFrames(float Rate) const
+{
+	if (FMath::Abs(Rate) > VlcMediaPlayer::MinThinnedRate)
+	{
+		return EVlcMediaSkipFrames::NonKey;
+	}
+
+	if ((DeliveryRate > 0.0f) && (DeliveryRate <= VlcMediaPlayer::MaxDecoderSkippingRate))
+	{
+		return EVlcMediaSkipFrames::BFrames;
+	}
+
+	return EVlcMediaSkipFrames::None;
+}
+
+
+void FVlcMediaPlayer::UpdateStats()
+{
+	FLibvlcMediaStats MediaStats;
+
+	if (FVlc::MediaGetStats(MediaSource.GetMedia(), &MediaStats))
+	{
+		Stats.Assign(MediaStats);
+	}
+
+	Callbacks.GetStats(Stats);
+	Callbacks.UpdateLatencies();
+	Recording.Update();
+	Stats.Publish();
+}
+
+
 /* FVlcMediaPlayer static functions
  *****************************************************************************/
 
@@ -529,6 +1726,6 @@ void FVlcMediaPlayer::StaticEventCallback(FLibvlcEvent* Event, void* UserData)
 
 	if (UserData != nullptr)
 	{
-		((FVlcMediaPlayer*)UserData)->Events.Enqueue(Event->Type);
+		((FVlcMediaPlayer*)UserData)->Events.Enqueue(*Event);
 	}
 }
@@ -3,17 +3,26 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Containers/Queue.h"
 #include "IMediaCache.h"
 #include "IMediaControls.h"
 #include "IMediaPlayer.h"
 #include "IMediaSamples.h"
+#include "IVlcMediaPlayer.h"
 
 #include "VlcMediaCallbacks.h"
+#include "VlcMediaEventRing.h"
+#include "VlcMediaKeyframeIndex.h"
+#include "VlcMediaRecording.h"
+#include "VlcMediaReverse.h"
 #include "VlcMediaSource.h"
+#include "VlcMediaStats.h"
+#include "VlcMediaSubtitles.h"
+#include "VlcMediaTimeshift.h"
 #include "VlcMediaTracks.h"
 #include "VlcMediaView.h"
 
+class FVlcMediaDemuxHints;
+class FVlcMediaProbeIndex;
 class IMediaEventSink;
 class IMediaOutput;
 
@@ -25,11 +34,28 @@ struct FLibvlcInstance;
 struct FLibvlcMediaPlayer;
 
 
+/**
+ * Frames that the decoder skips (values of VLC's avcodec-skip-frame option).
+ */
+enum class EVlcMediaSkipFrames : int32
+{
+	/** Decode all frames. */
+	None = 0,
+
+	/** Skip B-frames. */
+	BFrames = 1,
+
+	/** Skip all frames other than key frames. */
+	NonKey = 3
+};
+
+
 /**
  * Implements a media player using the Video LAN Codec (VLC) framework.
  */
 class FVlcMediaPlayer
 	: public IMediaPlayer
+	, public IVlcMediaPlayer
 	, protected IMediaCache
 	, protected IMediaControls
 {
@@ -40,8 +66,10 @@ public:
 	 *
 	 * @param InEventSink The object that receives media events from this player.
 	 * @param InInstance The LibVLC instance to use.
+	 * @param InProbeIndex The media probe index to use (optional).
+	 * @param InDemuxHints The demuxer probe order to use for archives (optional).
 	 */
-	FVlcMediaPlayer(IMediaEventSink& InEventSink, FLibvlcInstance* InInstance);
+	FVlcMediaPlayer(IMediaEventSink& InEventSink, FLibvlcInstance* InInstance, FVlcMediaProbeIndex* InProbeIndex, FVlcMediaDemuxHints* InDemuxHints);
 
 	/** Virtual destructor. */
 	virtual ~FVlcMediaPlayer();
@@ -64,15 +92,277 @@ public:
 	virtual bool Open(const TSharedRef<FArchive, ESPMode::ThreadSafe>& Archive, const FString& OriginalUrl, const IMediaOptions* Options) override;
 	virtual void TickInput(FTimespan DeltaTime, FTimespan Timecode) override;
 
+public:
+
+	//~ IVlcMediaPlayer interface
+
+	virtual float GetDeliveryRate() const override;
+	virtual bool IsDecodingAudio() const override;
+	virtual bool IsDecodingVideo() const override;
+	virtual bool IsRecording() const override;
+	virtual bool IsStepPending() const override;
+	virtual bool SetDecodeStreams(bool Audio, bool Video) override;
+	virtual bool SetDeliveryRate(float FramesPerSecond) override;
+	virtual bool StartRecording(const FString& FilePath) override;
+	virtual bool StepFrames(int32 NumFrames) override;
+	virtual void StopRecording() override;
+
+public:
+
+	/**
+	 * Get the player's playback statistics.
+	 *
+	 * @return Statistics as of the last call to TickInput.
+	 */
+	const FVlcMediaPlayerStats& GetPlayerStats() const
+	{
+		return Stats;
+	}
+
+	/**
+	 * Check whether VLC reads the current media directly from its file path.
+	 *
+	 * @return true if read by path, false if streamed from an archive or opened by URL.
+	 * @see UVlcMediaSettings::NativeFileAccess
+	 */
+	bool IsNativeFileAccess() const
+	{
+		return MediaSource.IsPath();
+	}
+
+	/**
+	 * Get the callback timings as comma separated values.
+	 *
+	 * Each row contains the media URL, the name of the measured callback and
+	 * the columns described by FVlcMediaHistogram::GetCsvHeader.
+	 *
+	 * @param OutRows Will contain one row per timing histogram.
+	 */
+	void GetTimingRows(TArray<FString>& OutRows) const;
+
+public:
+
+	/**
+	 * Get the playback time as reported by VLC.
+	 *
+	 * Unlike the presentation time (see GetTime), this is the position of
+	 * VLC's input clock, which may lead or lag the presentation time.
+	 *
+	 * @return Decoder time.
+	 */
+	FTimespan GetDecoderTime() const;
+
+	/**
+	 * Stop following an external clock.
+	 *
+	 * @see SetClockTime
+	 */
+	void ReleaseClock();
+
+	/**
+	 * Drive the presentation time from an external clock.
+	 *
+	 * The player stops advancing its own time until ReleaseClock is called.
+	 *
+	 * @param Time The current time of the external clock.
+	 * @see ReleaseClock
+	 */
+	void SetClockTime(FTimespan Time);
+
+	/**
+	 * Set a correction factor that is applied to the requested playback rate.
+	 *
+	 * This is used to make VLC catch up with, or wait for, an external clock.
+	 *
+	 * @param Factor The correction factor (1.0 = no correction).
+	 * @return true on success, false otherwise.
+	 */
+	bool SetRateCorrection(float Factor);
+
 protected:
 
 	/**
-	 * Initialize the media player.
+	 * Check whether the current media can be decoded by the reverse playback cache.
+	 *
+	 * @return true if reverse playback and frame stepping are supported, false otherwise.
+	 * @see StartReverse
+	 */
+	bool CanReverse() const;
+
+	/**
+	 * Create the VLC media player object.
+	 *
+	 * The player object is created when the first media source is opened,
+	 * and it is reused for all subsequently opened media sources.
+	 *
+	 * @return true on success, false otherwise.
+	 * @see InitializePlayer
+	 */
+	bool CreatePlayer();
+
+	/**
+	 * Configure the decoder of the currently opened media source for the maximum output size.
+	 *
+	 * Some decoders can skip work when the output is downscaled anyway. The
+	 * decoder options are switchable options, so they only take effect when
+	 * the media is (re)started.
+	 *
+	 * @param SourceDim The dimensions of the media source's video.
+	 * @return true if the decoder options changed, false otherwise.
+	 * @see FVlcMediaCallbacks::SetMaxOutputDim, GetSwitchableOptions
+	 */
+	bool ConfigureDecoderScaling(const FIntPoint& SourceDim);
+
+	/**
+	 * Choose the demuxer for media that is streamed from an archive.
+	 *
+	 * VLC doesn't see the file name of such media, so the demuxer is chosen
+	 * by the original URL's extension instead of probing the stream.
+	 *
+	 * @param OriginalUrl The URL that the archive was opened from.
+	 * @see FVlcMediaDemuxHints
+	 */
+	void ConfigureDemuxHint(const FString& OriginalUrl);
+
+	/**
+	 * Configure the video output from the player's media options.
+	 *
+	 * @param Options The media options (optional).
+	 * @see FVlcMediaCallbacks::SetMaxOutputDim, FVlcMediaCallbacks::SetSkipDuplicateFrames, SetDecodeStreams, SetDeliveryRate
+	 */
+	void ConfigureOutput(const IMediaOptions* Options);
+
+	/**
+	 * Configure the currently opened media source for low-latency playback, if applicable.
+	 *
+	 * @param Url The media source's URL.
+	 * @param Options Optional media options.
+	 * @see UVlcMediaSettings::LowLatencyLive
+	 */
+	void ConfigureLowLatency(const FString& Url, const IMediaOptions* Options);
+
+	/**
+	 * Initialize the media player for the currently opened media source.
 	 *
 	 * @return true on success, false otherwise.
+	 * @see CreatePlayer
 	 */
 	bool InitializePlayer();
 
+	/**
+	 * Load the subtitle files of the current media file.
+	 *
+	 * If subtitle files are found, they replace VLC's subtitle streams,
+	 * which then don't need to be decoded and blended anymore. Subtitle
+	 * files that can't be parsed are added to the media as VLC input slaves.
+	 *
+	 * @see FVlcMediaSubtitles
+	 */
+	void LoadSubtitles();
+
+	/**
+	 * Get all timing histograms.
+	 *
+	 * @param OutTimings Will contain the histograms and their names.
+	 */
+	void GetTimings(TArray<TPair<const TCHAR*, const FVlcMediaHistogram*>>& OutTimings) const;
+
+	/**
+	 * Get the frames that the decoder should skip.
+	 *
+	 * Thinned playback rates decode key frames only, and low delivery rates
+	 * skip B-frames (see SetDeliveryRate).
+	 *
+	 * @param Rate The playback rate.
+	 * @return Frames to skip.
+	 */
+	EVlcMediaSkipFrames GetSkipFrames(float Rate) const;
+
+	/**
+	 * Get the media options that depend on the player's current settings.
+	 *
+	 * Unlike other options, these are not kept by the media source, so that
+	 * they can change when the media restarts.
+	 *
+	 * @param Rate The playback rate that the options are for.
+	 * @param OutOptions Will contain the options.
+	 * @see RestartMedia
+	 */
+	void GetSwitchableOptions(float Rate, TArray<FString>& OutOptions) const;
+
+	/**
+	 * Restart the current media source at the current playback time.
+	 *
+	 * This is used to change stream output and decoder options, which VLC
+	 * only applies when the media starts playing.
+	 *
+	 * @param Rate The playback rate to continue with.
+	 * @return true on success, false otherwise.
+	 * @see GetSwitchableOptions
+	 */
+	bool RestartMedia(float Rate);
+
+	/**
+	 * Seek within the time-shift window.
+	 *
+	 * VLC only knows the segments that are currently in the playlist, so this
+	 * seeks by position within the window rather than by time.
+	 *
+	 * @param Time The time to seek to, measured from the start of the recording.
+	 * @see FVlcMediaTimeshift::GetWindowStart
+	 */
+	void SeekTimeshift(FTimespan Time);
+
+	/**
+	 * Start delivering frames from the reverse playback cache at the current playback time.
+	 *
+	 * The VLC player is paused, and frames are decoded by the reverse playback
+	 * cache instead (see FVlcMediaReverse). This is used for negative rates
+	 * and frame stepping.
+	 *
+	 * @return true on success, false otherwise.
+	 * @see StopReverse, TickReverse
+	 */
+	bool StartReverse();
+
+	/**
+	 * Stop playing in reverse and continue with the VLC player at the current playback time.
+	 *
+	 * @see StartReverse
+	 */
+	void StopReverse();
+
+	/**
+	 * Stop decoding towards the target of an indexed seek.
+	 *
+	 * The VLC player continues at the playback rate it had before the seek.
+	 *
+	 * @param SeekPrecisely Whether VLC should seek the rest of the way if the target wasn't reached yet.
+	 * @see Seek
+	 */
+	void StopSeekCatchUp(bool SeekPrecisely);
+
+	/**
+	 * Advance reverse playback and deliver the frame for the current time.
+	 *
+	 * @param DeltaTime Time since the last tick.
+	 * @see StartReverse
+	 */
+	void TickReverse(FTimespan DeltaTime);
+
+	/** Update the playback statistics. */
+	void UpdateStats();
+
+	/**
+	 * Check whether a media source is currently open.
+	 *
+	 * @return true if media is open, false otherwise.
+	 */
+	bool IsMediaOpen() const
+	{
+		return (Player != nullptr) && (MediaSource.GetMedia() != nullptr);
+	}
+
 protected:
 
 	//~ IMediaControls interface
@@ -96,6 +386,9 @@ private:
 
 private:
 
+	/** Progress of VLC's input buffering (in percent). */
+	float BufferingProgress;
+
 	/** VLC callback manager. */
 	FVlcMediaCallbacks Callbacks;
 
@@ -105,27 +398,114 @@ private:
 	/** Current playback time (to work around VLC's broken time tracking). */
 	FTimespan CurrentTime;
 
+	/** Whether audio is decoded. */
+	bool DecodeAudio;
+
+	/** Whether video is decoded. */
+	bool DecodeVideo;
+
+	/** Video dimensions that the decoder scales down for (zero = no scaling). */
+	FIntPoint DecoderScaledDim;
+
+	/** Maximum rate at which video frames are delivered (zero = no limit). */
+	float DeliveryRate;
+
+	/** Lower case file extension of the current archive's original URL. */
+	FString DemuxExtension;
+
+	/** The demuxer that is forced for the current media (empty = probe). */
+	FString DemuxHint;
+
+	/** Whether the forced demuxer opened the current media. */
+	bool DemuxHintConfirmed;
+
+	/** Demuxer probe order for archives (optional). */
+	FVlcMediaDemuxHints* DemuxHints;
+
 	/** The media event handler. */
 	IMediaEventSink& EventSink;
 
-	/** Collection of received player events. */
-	TQueue<ELibvlcEventType, EQueueMode::Mpsc> Events;
+	/** Whether the presentation time is driven by an external clock. */
+	bool ExternalClock;
+
+	/** The forced demuxer that failed to open the current media, while VLC probes it instead (empty = none). */
+	FString FailedDemuxHint;
 
-	/** Media information string. */
-	FString Info;
+	/** Whether the current media object seeks by byte offset, so the key frame index can be used. */
+	bool IndexedSeeking;
+
+	/** Key frame index of the currently open media file (if supported). */
+	FVlcMediaKeyframeIndex KeyframeIndex;
+
+	/** Received player events. */
+	FVlcMediaEventRing Events;
 
 	/** The media source (from URL or archive). */
 	FVlcMediaSource MediaSource;
 
-	/** The VLC media player object. */
+	/** Caching duration of the current media source if it plays with low latency (zero otherwise). */
+	FTimespan LowLatencyCaching;
+
+	/** Path of the currently open media file (empty if not a local file). */
+	FString MediaFilePath;
+
+	/** Play time since the media was opened (for estimating source frames). */
+	FTimespan PlayedTime;
+
+	/** The VLC media player object (reused across media sources). */
 	FLibvlcMediaPlayer* Player;
 
+	/** Index of previously probed media files (optional). */
+	FVlcMediaProbeIndex* ProbeIndex;
+
+	/** Correction factor applied to the requested playback rate. */
+	float RateCorrection;
+
+	/** Recording of the current media (if any). */
+	FVlcMediaRecording Recording;
+
+	/** Reverse playback of the current media (if playing in reverse). */
+	FVlcMediaReverse Reverse;
+
+	/** The most recently delivered frame of reverse playback. */
+	TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe> ReverseSample;
+
+	/** Time to continue at once a restarted media plays (zero if none). */
+	FTimespan RestartTime;
+
+	/** VLC playback rate to continue with once the target of an indexed seek is reached. */
+	float SeekResumeRate;
+
+	/** Requested time of an indexed seek that is still decoding towards it from the key frame (zero = none). */
+	FTimespan SeekTarget;
+
 	/** Whether playback should be looping. */
 	bool ShouldLoop;
 
+	/** Frames that the decoder of the current media skips. */
+	EVlcMediaSkipFrames SkipFrames;
+
+	/** Whether a frame step waits for its target frame (see StepFrames). */
+	bool StepPending;
+
+	/** Playback statistics (updated in TickInput). */
+	FVlcMediaPlayerStats Stats;
+
+	/** Subtitle tracks loaded from files next to the media. */
+	FVlcMediaSubtitles Subtitles;
+
+	/** Time-shift recording of the current live stream (if enabled). */
+	FVlcMediaTimeshift Timeshift;
+
+	/** URL of the live stream being time-shifted. */
+	FString TimeshiftUrl;
+
 	/** Track collection. */
 	FVlcMediaTracks Tracks;
 
 	/** View settings. */
 	FVlcMediaView View;
+
+	/** The LibVLC instance. */
+	FLibvlcInstance* VlcInstance;
 };
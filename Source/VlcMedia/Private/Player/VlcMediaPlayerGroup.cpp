@@ -0,0 +1,263 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaPlayerGroup.h"
+#include "VlcMediaPrivate.h"
+
+#include "HAL/PlatformTime.h"
+#include "IMediaControls.h"
+
+#include "VlcMediaPlayer.h"
+
+
+namespace VlcMediaPlayerGroup
+{
+	/** Time between drift corrections (in seconds). */
+	const double CorrectionInterval = 0.25;
+
+	/** Time over which drift is corrected via rate adjustments (in seconds). */
+	const double CorrectionWindow = 2.0;
+
+	/** Maximum relative playback rate adjustment. */
+	const float MaxRateCorrection = 0.05f;
+
+	/** Drift below which no correction is applied. */
+	const FTimespan Tolerance = FTimespan::FromMilliseconds(15.0);
+
+	/** Drift above which members are re-synchronized by seeking. */
+	const FTimespan SeekThreshold = FTimespan::FromMilliseconds(500.0);
+
+	/** Weight of new measurements in the smoothed synchronization error. */
+	const double SmoothingFactor = 0.3;
+}
+
+
+/* FVlcMediaPlayerGroup structors
+ *****************************************************************************/
+
+FVlcMediaPlayerGroup::FVlcMediaPlayerGroup()
+	: BaseTime(FTimespan::Zero())
+	, BaseSeconds(FPlatformTime::Seconds())
+	, LastCorrectionSeconds(0.0)
+	, Rate(0.0f)
+{
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FVlcMediaPlayerGroup::HandleTicker));
+}
+
+
+FVlcMediaPlayerGroup::~FVlcMediaPlayerGroup()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	for (const FMember& Member : Members)
+	{
+		TSharedPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player = Member.Player.Pin();
+
+		if (Player.IsValid())
+		{
+			Player->ReleaseClock();
+		}
+	}
+}
+
+
+/* IVlcMediaPlayerGroup interface
+ *****************************************************************************/
+
+bool FVlcMediaPlayerGroup::AddPlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player)
+{
+	if (Player->GetPlayerName() != FName(TEXT("VlcMedia")))
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Player group %p: Only VlcMedia players can be grouped"), this);
+		return false;
+	}
+
+	TSharedRef<FVlcMediaPlayer, ESPMode::ThreadSafe> VlcPlayer = StaticCastSharedRef<FVlcMediaPlayer>(Player);
+
+	if (Members.ContainsByPredicate([&](const FMember& Member) { return (Member.Player.Pin().Get() == &VlcPlayer.Get()); }))
+	{
+		return true;
+	}
+
+	FMember Member;
+	{
+		Member.Player = VlcPlayer;
+		Member.SyncError = FTimespan::Zero();
+	}
+
+	Members.Add(Member);
+
+	// bring the new member in line with the others
+	VlcPlayer->GetControls().Seek(GetTime());
+	VlcPlayer->GetControls().SetRate(Rate);
+	VlcPlayer->SetClockTime(GetTime());
+
+	return true;
+}
+
+
+FTimespan FVlcMediaPlayerGroup::GetSyncError(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) const
+{
+	for (const FMember& Member : Members)
+	{
+		if (Member.Player.Pin().Get() == &StaticCastSharedRef<FVlcMediaPlayer>(Player).Get())
+		{
+			return Member.SyncError;
+		}
+	}
+
+	return FTimespan::Zero();
+}
+
+
+FTimespan FVlcMediaPlayerGroup::GetTime() const
+{
+	return BaseTime + FTimespan::FromSeconds((FPlatformTime::Seconds() - BaseSeconds) * Rate);
+}
+
+
+bool FVlcMediaPlayerGroup::Pause()
+{
+	return Play(0.0f);
+}
+
+
+bool FVlcMediaPlayerGroup::Play(float InRate)
+{
+	RestartClock();
+	Rate = InRate;
+
+	bool Succeeded = true;
+
+	for (FMember& Member : Members)
+	{
+		TSharedPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player = Member.Player.Pin();
+
+		if (Player.IsValid())
+		{
+			Player->SetRateCorrection(1.0f);
+			Succeeded &= Player->GetControls().SetRate(Rate);
+			Member.SyncError = FTimespan::Zero();
+		}
+	}
+
+	return Succeeded;
+}
+
+
+void FVlcMediaPlayerGroup::RemovePlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player)
+{
+	TSharedRef<FVlcMediaPlayer, ESPMode::ThreadSafe> VlcPlayer = StaticCastSharedRef<FVlcMediaPlayer>(Player);
+
+	if (Members.RemoveAll([&](const FMember& Member) { return (Member.Player.Pin().Get() == &VlcPlayer.Get()); }) > 0)
+	{
+		VlcPlayer->ReleaseClock();
+	}
+}
+
+
+bool FVlcMediaPlayerGroup::Seek(const FTimespan& Time)
+{
+	BaseTime = Time;
+	BaseSeconds = FPlatformTime::Seconds();
+
+	bool Succeeded = true;
+
+	for (FMember& Member : Members)
+	{
+		TSharedPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player = Member.Player.Pin();
+
+		if (Player.IsValid())
+		{
+			Succeeded &= Player->GetControls().Seek(Time);
+			Player->SetClockTime(Time);
+			Member.SyncError = FTimespan::Zero();
+		}
+	}
+
+	return Succeeded;
+}
+
+
+/* FVlcMediaPlayerGroup implementation
+ *****************************************************************************/
+
+void FVlcMediaPlayerGroup::CorrectDrift()
+{
+	using namespace VlcMediaPlayerGroup;
+
+	const FTimespan MasterTime = GetTime();
+
+	for (FMember& Member : Members)
+	{
+		TSharedPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player = Member.Player.Pin();
+
+		if (!Player.IsValid() || (Player->GetControls().GetState() != EMediaState::Playing))
+		{
+			continue;
+		}
+
+		const FTimespan Drift = Player->GetDecoderTime() - MasterTime;
+		Member.SyncError = FTimespan((int64)(Member.SyncError.GetTicks() * (1.0 - SmoothingFactor) + Drift.GetTicks() * SmoothingFactor));
+
+		if (FMath::Abs(Drift.GetTicks()) > SeekThreshold.GetTicks())
+		{
+			UE_LOG(LogVlcMedia, Verbose, TEXT("Player group %p: Re-synchronizing player %p (drift %.3f s)"), this, Player.Get(), Drift.GetTotalSeconds());
+
+			Player->SetRateCorrection(1.0f);
+			Player->GetControls().Seek(MasterTime);
+			Member.SyncError = FTimespan::Zero();
+
+			continue;
+		}
+
+		float Correction = 1.0f;
+
+		if (FMath::Abs(Member.SyncError.GetTicks()) > Tolerance.GetTicks())
+		{
+			// slow down members that are ahead, speed up members that are behind
+			Correction = 1.0f - FMath::Clamp((float)(Member.SyncError.GetTotalSeconds() / CorrectionWindow), -MaxRateCorrection, MaxRateCorrection);
+		}
+
+		Player->SetRateCorrection(Correction);
+	}
+}
+
+
+void FVlcMediaPlayerGroup::RestartClock()
+{
+	BaseTime = GetTime();
+	BaseSeconds = FPlatformTime::Seconds();
+}
+
+
+/* FVlcMediaPlayerGroup callbacks
+ *****************************************************************************/
+
+bool FVlcMediaPlayerGroup::HandleTicker(float /*DeltaTime*/)
+{
+	Members.RemoveAll([](const FMember& Member) { return !Member.Player.IsValid(); });
+
+	// correct drift periodically, as VLC's clock only updates coarsely
+	const double Now = FPlatformTime::Seconds();
+
+	if ((Rate != 0.0f) && (Now - LastCorrectionSeconds >= VlcMediaPlayerGroup::CorrectionInterval))
+	{
+		CorrectDrift();
+		LastCorrectionSeconds = Now;
+	}
+
+	// all members present the master time
+	const FTimespan MasterTime = GetTime();
+
+	for (const FMember& Member : Members)
+	{
+		TSharedPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player = Member.Player.Pin();
+
+		if (Player.IsValid())
+		{
+			Player->SetClockTime(MasterTime);
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,80 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "IVlcMediaPlayerGroup.h"
+
+class FVlcMediaPlayer;
+
+
+/**
+ * Implements a group of VLC media players that play in sync.
+ */
+class FVlcMediaPlayerGroup
+	: public IVlcMediaPlayerGroup
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaPlayerGroup();
+
+	/** Virtual destructor. */
+	virtual ~FVlcMediaPlayerGroup();
+
+public:
+
+	//~ IVlcMediaPlayerGroup interface
+
+	virtual bool AddPlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) override;
+	virtual FTimespan GetSyncError(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) const override;
+	virtual FTimespan GetTime() const override;
+	virtual bool Pause() override;
+	virtual bool Play(float Rate) override;
+	virtual void RemovePlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) override;
+	virtual bool Seek(const FTimespan& Time) override;
+
+protected:
+
+	/** Measure and correct the drift of all group members. */
+	void CorrectDrift();
+
+	/** Restart the master clock at its current time. */
+	void RestartClock();
+
+private:
+
+	/** Callback for the core ticker. */
+	bool HandleTicker(float DeltaTime);
+
+private:
+
+	/** A group member. */
+	struct FMember
+	{
+		/** The member's player. */
+		TWeakPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player;
+
+		/** Smoothed synchronization error (decoder time minus master time). */
+		FTimespan SyncError;
+	};
+
+	/** Master time when the clock was last restarted. */
+	FTimespan BaseTime;
+
+	/** Platform time (in seconds) when the clock was last restarted. */
+	double BaseSeconds;
+
+	/** Platform time (in seconds) of the last drift correction. */
+	double LastCorrectionSeconds;
+
+	/** The group members. */
+	TArray<FMember> Members;
+
+	/** Current playback rate. */
+	float Rate;
+
+	/** Handle to the registered ticker. */
+	FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,179 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaRecording.h"
+#include "VlcMediaPrivate.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+
+namespace VlcMediaRecording
+{
+	/** Time between measurements (in seconds). */
+	const double UpdateInterval = 1.0;
+}
+
+
+/* FVlcMediaRecording structors
+ *****************************************************************************/
+
+FVlcMediaRecording::FVlcMediaRecording()
+	: BaselineCpu(0.0f)
+	, BytesWritten(0)
+	, CompletedBytes(0)
+	, CpuSum(0.0)
+	, LastUpdateSeconds(0.0)
+	, NumCpuSamples(0)
+	, NumFiles(0)
+	, StartSeconds(0.0)
+{ }
+
+
+/* FVlcMediaRecording interface
+ *****************************************************************************/
+
+FString FVlcMediaRecording::GetStats() const
+{
+	const double Seconds = FPlatformTime::Seconds() - StartSeconds;
+	const double Throughput = (Seconds > 0.0) ? (BytesWritten / Seconds) : 0.0;
+	const float AverageCpu = (NumCpuSamples > 0) ? (float)(CpuSum / NumCpuSamples) : BaselineCpu;
+
+	FString StatsString;
+	{
+		StatsString += FString::Printf(TEXT("    File: %s\n"), *FilePath);
+		StatsString += FString::Printf(TEXT("    Files: %i\n"), NumFiles);
+		StatsString += FString::Printf(TEXT("    Duration: %.1f s\n"), Seconds);
+		StatsString += FString::Printf(TEXT("    Bytes Written: %lli\n"), BytesWritten);
+		StatsString += FString::Printf(TEXT("    Disk Throughput: %.1f KB/s\n"), Throughput / 1024.0);
+		StatsString += FString::Printf(TEXT("    Process CPU: %.1f%% (%.1f%% before recording)\n"), AverageCpu, BaselineCpu);
+	}
+
+	return StatsString;
+}
+
+
+FString FVlcMediaRecording::OpenOutput(bool DisplayAudio, bool DisplayVideo, bool DisplaySubtitles)
+{
+	if (NumFiles > 0)
+	{
+		const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+
+		if (FileSize > 0)
+		{
+			CompletedBytes += FileSize;
+		}
+
+		FilePath = FString::Printf(TEXT("%s_%i%s"), *FPaths::GetBaseFilename(FirstFilePath, false), NumFiles, *FPaths::GetExtension(FirstFilePath, true));
+
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Continuing recording in %s"), *FilePath);
+	}
+
+	++NumFiles;
+
+	const FString Extension = FPaths::GetExtension(FilePath).ToLower();
+	const TCHAR* Mux = TEXT("ts");
+
+	if (Extension == TEXT("mkv"))
+	{
+		Mux = TEXT("mkv");
+	}
+	else if ((Extension == TEXT("mp4")) || (Extension == TEXT("m4v")))
+	{
+		Mux = TEXT("mp4");
+	}
+	else if ((Extension == TEXT("ogg")) || (Extension == TEXT("ogv")))
+	{
+		Mux = TEXT("ogg");
+	}
+
+	// streams that aren't played are only dropped from the display
+	TArray<FString> Deselected;
+
+	if (!DisplayAudio)
+	{
+		Deselected.Add(TEXT("noaudio"));
+	}
+
+	if (!DisplayVideo)
+	{
+		Deselected.Add(TEXT("novideo"));
+	}
+
+	if (!DisplaySubtitles)
+	{
+		Deselected.Add(TEXT("nospu"));
+	}
+
+	FString Display = TEXT("dst=display");
+
+	if (Deselected.Num() > 0)
+	{
+		Display += FString::Printf(TEXT(",select=\"%s\""), *FString::Join(Deselected, TEXT(",")));
+	}
+
+	// display the stream as usual, and remux a copy of it into the file
+	return FString::Printf(TEXT(":sout=#duplicate{%s,dst=std{access=file,mux=%s,dst=\"%s\"}}"), *Display, Mux, *FilePath.Replace(TEXT("\\"), TEXT("/")));
+}
+
+
+bool FVlcMediaRecording::Start(const FString& InFilePath)
+{
+	const FString FullPath = FPaths::ConvertRelativePathToFull(InFilePath);
+
+	if (!IFileManager::Get().MakeDirectory(*FPaths::GetPath(FullPath), true))
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to create directory for recording %s"), *FullPath);
+		return false;
+	}
+
+	FilePath = FullPath;
+	FirstFilePath = FullPath;
+	BaselineCpu = FPlatformTime::GetCPUTime().CPUTimePctRelative;
+	BytesWritten = 0;
+	CompletedBytes = 0;
+	CpuSum = 0.0;
+	NumCpuSamples = 0;
+	NumFiles = 0;
+	StartSeconds = FPlatformTime::Seconds();
+	LastUpdateSeconds = StartSeconds;
+
+	return true;
+}
+
+
+void FVlcMediaRecording::Stop()
+{
+	if (FilePath.IsEmpty())
+	{
+		return;
+	}
+
+	UE_LOG(LogVlcMedia, Log, TEXT("Finished recording\n%s"), *GetStats());
+
+	FilePath.Reset();
+	FirstFilePath.Reset();
+}
+
+
+void FVlcMediaRecording::Update()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	if (FilePath.IsEmpty() || (Now - LastUpdateSeconds < VlcMediaRecording::UpdateInterval))
+	{
+		return;
+	}
+
+	LastUpdateSeconds = Now;
+
+	const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+
+	if (FileSize > 0)
+	{
+		BytesWritten = CompletedBytes + FileSize;
+	}
+
+	CpuSum += FPlatformTime::GetCPUTime().CPUTimePctRelative;
+	++NumCpuSamples;
+}
@@ -0,0 +1,121 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/**
+ * Tracks a recording of the media that is being played.
+ *
+ * The recording itself is performed by VLC's stream output, which duplicates
+ * the demuxed streams into the display and a file. This class generates the
+ * stream output option and measures the cost of the recording, i.e. how fast
+ * the file grows and how much process CPU time is used compared to playback
+ * before the recording started.
+ */
+class FVlcMediaRecording
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaRecording();
+
+public:
+
+	/**
+	 * Get the path of the file being recorded to.
+	 *
+	 * @return File path (empty if not recording).
+	 */
+	const FString& GetFilePath() const
+	{
+		return FilePath;
+	}
+
+	/**
+	 * Get a human readable summary of the recording's throughput and overhead.
+	 *
+	 * @return Statistics string.
+	 */
+	FString GetStats() const;
+
+	/**
+	 * Check whether a recording is active.
+	 *
+	 * @return true if recording, false otherwise.
+	 */
+	bool IsActive() const
+	{
+		return !FilePath.IsEmpty();
+	}
+
+	/**
+	 * Open an output file and get the stream output option that records to it.
+	 *
+	 * This must be called each time the media (re)starts while recording. The
+	 * first call records to the file the recording was started with. Opening
+	 * that file again would truncate it, so each later call continues the
+	 * recording in a new file with a running number appended to its name.
+	 *
+	 * Streams that aren't decoded are deselected in the display branch of the
+	 * stream output, so that the file still contains all streams.
+	 *
+	 * @param DisplayAudio Whether audio is decoded for display.
+	 * @param DisplayVideo Whether video is decoded for display.
+	 * @param DisplaySubtitles Whether subtitles are decoded for display.
+	 * @return The media option, i.e. ":sout=#duplicate{...}".
+	 */
+	FString OpenOutput(bool DisplayAudio, bool DisplayVideo, bool DisplaySubtitles);
+
+	/**
+	 * Start tracking a recording.
+	 *
+	 * @param InFilePath The file to record to.
+	 * @return true on success, false if the file can't be written.
+	 * @see Stop
+	 */
+	bool Start(const FString& InFilePath);
+
+	/**
+	 * Stop tracking the recording and log its statistics.
+	 *
+	 * @see Start
+	 */
+	void Stop();
+
+	/** Sample the file size and CPU usage. */
+	void Update();
+
+private:
+
+	/** Process CPU usage (in percent) before the recording started. */
+	float BaselineCpu;
+
+	/** Size of the recorded files (in bytes) as of the last update. */
+	int64 BytesWritten;
+
+	/** Size of the files that were completed before the current one (in bytes). */
+	int64 CompletedBytes;
+
+	/** Sum of the process CPU usage samples taken while recording. */
+	double CpuSum;
+
+	/** Path of the file being recorded to. */
+	FString FilePath;
+
+	/** Path of the file that the recording was started with. */
+	FString FirstFilePath;
+
+	/** Time of the last update (in seconds). */
+	double LastUpdateSeconds;
+
+	/** Number of CPU usage samples taken while recording. */
+	int32 NumCpuSamples;
+
+	/** Number of files opened so far. */
+	int32 NumFiles;
+
+	/** Time when the recording started (in seconds). */
+	double StartSeconds;
+};
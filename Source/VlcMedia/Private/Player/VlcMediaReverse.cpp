@@ -0,0 +1,668 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaReverse.h"
+#include "VlcMediaPrivate.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+#include "Vlc.h"
+#include "VlcMediaKeyframeIndex.h"
+#include "VlcMediaTextureSample.h"
+
+
+namespace VlcMediaReverse
+{
+	/** Length of the chunks that are decoded if no key frame index is available. */
+	const FTimespan ChunkLength = FTimespan::FromSeconds(1.0);
+
+	/** Rate at which chunks are decoded. */
+	const float DecodeRate = 4.0f;
+
+	/** Time that is decoded past the first requested frame, so that it is not missed. */
+	const FTimespan EndMargin = FTimespan::FromMilliseconds(100.0);
+
+	/** Time after which a decode is abandoned (in seconds, in addition to the chunk length). */
+	const double Timeout = 10.0;
+}
+
+
+/* FVlcMediaReverse structors
+ *****************************************************************************/
+
+FVlcMediaReverse::FVlcMediaReverse()
+	: CacheBytes(0)
+	, DecodeSeconds(0.0)
+	, DecodingStart(FTimespan::Zero())
+	, DecodedFrames(0)
+	, DecodeStartSeconds(0.0)
+	, DecoderTime(FTimespan::MinValue())
+	, DecoderTimeOrigin(FTimespan::MinValue())
+	, Dim(FIntPoint::ZeroValue)
+	, Duration(FTimespan::Zero())
+	, ExpectedChunkLength(FTimespan::Zero())
+	, Forward(false)
+	, FrameDuration(FTimespan::Zero())
+	, FrameTimeOrigin(FTimespan::Zero())
+	, KeyframeIndex(nullptr)
+	, LastFetchTime(FTimespan::Zero())
+	, LastTickTime(FTimespan::Zero())
+	, LocationIsPath(false)
+	, MaxCacheSize(0)
+	, MaxOutputDim(0)
+	, Player(nullptr)
+	, PreviousFrameTime(FTimespan::MinValue())
+	, ReversedTime(FTimespan::Zero())
+	, SamplePool(new FVlcMediaTextureSamplePool)
+	, VlcInstance(nullptr)
+{ }
+
+
+FVlcMediaReverse::~FVlcMediaReverse()
+{
+	Stop();
+
+	delete SamplePool;
+	SamplePool = nullptr;
+}
+
+
+/* FVlcMediaReverse interface
+ *****************************************************************************/
+
+bool FVlcMediaReverse::FetchFrame(FTimespan Time, TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe>& OutSample)
+{
+	const FChunk* Chunk = FindChunk(Time);
+
+	if ((Chunk == nullptr) || !Chunk->Complete)
+	{
+		return false;
+	}
+
+	const int32 FrameIndex = FindFrame(*Chunk, Time);
+
+	if (FrameIndex != INDEX_NONE)
+	{
+		OutSample = Chunk->Frames[FrameIndex];
+	}
+	else
+	{
+		OutSample.Reset();
+	}
+
+	if (Time < LastFetchTime)
+	{
+		ReversedTime += LastFetchTime - Time;
+	}
+
+	LastFetchTime = Time;
+
+	return true;
+}
+
+
+FString FVlcMediaReverse::GetStats() const
+{
+	const double ReversedSeconds = ReversedTime.GetTotalSeconds();
+
+	FString Result;
+	{
+		Result += FString::Printf(TEXT("    Cached Chunks: %i\n"), Chunks.Num());
+		Result += FString::Printf(TEXT("    Cache Size: %.1f of %.1f MB\n"), CacheBytes / (1024.0 * 1024.0), MaxCacheSize / (1024.0 * 1024.0));
+		Result += FString::Printf(TEXT("    Decoded Frames: %i (%ix%i)\n"), DecodedFrames, Dim.X, Dim.Y);
+		Result += FString::Printf(TEXT("    Reversed Time: %.1f s\n"), ReversedSeconds);
+
+		if (ReversedSeconds > 0.0)
+		{
+			Result += FString::Printf(TEXT("    Decode Time per Reversed Second: %.2f s\n"), DecodeSeconds / ReversedSeconds);
+			Result += FString::Printf(TEXT("    Decoded Frames per Reversed Second: %.1f\n"), DecodedFrames / ReversedSeconds);
+		}
+	}
+
+	return Result;
+}
+
+
+bool FVlcMediaReverse::Start(FLibvlcInstance* InVlcInstance, const FString& InLocation, bool IsPath, FVlcMediaKeyframeIndex* InKeyframeIndex, FTimespan InDuration, int32 InMaxOutputDim, SIZE_T InMaxCacheSize)
+{
+	Stop();
+
+	Player = FVlc::MediaPlayerNew(InVlcInstance);
+
+	if (Player == nullptr)
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to create reverse playback decoder: %s"), ANSI_TO_TCHAR(FVlc::Errmsg()));
+		return false;
+	}
+
+	FVlc::VideoSetFormatCallbacks(Player, &FVlcMediaReverse::StaticSetupCallback, nullptr);
+	FVlc::VideoSetCallbacks(Player, &FVlcMediaReverse::StaticLockCallback, &FVlcMediaReverse::StaticUnlockCallback, &FVlcMediaReverse::StaticDisplayCallback, this);
+
+	DecodeSeconds = 0.0;
+	DecodedFrames = 0;
+	Duration = InDuration;
+	ExpectedChunkLength = FMath::Max(VlcMediaReverse::ChunkLength, (InKeyframeIndex != nullptr) ? InKeyframeIndex->GetAverageInterval() : FTimespan::Zero());
+	Forward = false;
+	KeyframeIndex = InKeyframeIndex;
+	LastFetchTime = FTimespan::Zero();
+	LastTickTime = FTimespan::Zero();
+	Location = InLocation;
+	LocationIsPath = IsPath;
+	MaxCacheSize = InMaxCacheSize;
+	MaxOutputDim = InMaxOutputDim;
+	ReversedTime = FTimespan::Zero();
+	VlcInstance = InVlcInstance;
+
+	return true;
+}
+
+
+bool FVlcMediaReverse::StepFrames(FTimespan Time, int32 NumFrames, FTimespan FrameDuration, FTimespan& OutTime) const
+{
+	const FChunk* Chunk = FindChunk(Time);
+	const int32 FrameIndex = ((Chunk != nullptr) && Chunk->Complete) ? FindFrame(*Chunk, Time) : INDEX_NONE;
+
+	if (FrameIndex == INDEX_NONE)
+	{
+		OutTime = Time + FrameDuration * NumFrames;
+		return false;
+	}
+
+	int32 TargetIndex = FrameIndex + NumFrames;
+
+	while (true)
+	{
+		if (TargetIndex < 0)
+		{
+			const FTimespan FirstTime = Chunk->Frames[0]->GetTime();
+
+			if (Chunk->Start <= FTimespan::Zero())
+			{
+				OutTime = FirstTime; // can't step before the first frame
+				return true;
+			}
+
+			const FChunk* Previous = FindChunk(Chunk->Start - FTimespan(1));
+
+			if ((Previous == nullptr) || !Previous->Complete || (Previous->Frames.Num() == 0))
+			{
+				OutTime = FirstTime + FrameDuration * TargetIndex;
+				return false;
+			}
+
+			TargetIndex += Previous->Frames.Num();
+			Chunk = Previous;
+		}
+		else if (TargetIndex >= Chunk->Frames.Num())
+		{
+			const FTimespan LastTime = Chunk->Frames.Last()->GetTime();
+
+			if ((Duration > FTimespan::Zero()) && (Chunk->End >= Duration))
+			{
+				OutTime = LastTime; // can't step past the last frame
+				return true;
+			}
+
+			const FChunk* Next = FindChunk(Chunk->End);
+
+			if ((Next == nullptr) || !Next->Complete || (Next->Frames.Num() == 0))
+			{
+				OutTime = LastTime + FrameDuration * (TargetIndex - Chunk->Frames.Num() + 1);
+				return false;
+			}
+
+			TargetIndex -= Chunk->Frames.Num();
+			Chunk = Next;
+		}
+		else
+		{
+			OutTime = Chunk->Frames[TargetIndex]->GetTime();
+			return true;
+		}
+	}
+}
+
+
+void FVlcMediaReverse::Stop()
+{
+	if (Player == nullptr)
+	{
+		return;
+	}
+
+	FVlc::MediaPlayerStop(Player);
+	FVlc::MediaPlayerRelease(Player);
+	Player = nullptr;
+
+	{
+		FScopeLock Lock(&CriticalSection);
+		Decoding.Reset();
+	}
+
+	CacheBytes = 0;
+	Chunks.Empty();
+	KeyframeIndex = nullptr;
+	SamplePool->Reset();
+}
+
+
+void FVlcMediaReverse::Tick(FTimespan Time)
+{
+	if (Player == nullptr)
+	{
+		return;
+	}
+
+	if (Time != LastTickTime)
+	{
+		Forward = (Time > LastTickTime);
+		LastTickTime = Time;
+	}
+
+	// collect the decoded chunk
+	if (Decoding.IsValid())
+	{
+		const ELibvlcState State = FVlc::MediaPlayerGetState(Player);
+		const double MaxSeconds = VlcMediaReverse::Timeout + (Decoding->End - DecodingStart).GetTotalSeconds();
+
+		if (State == ELibvlcState::Playing)
+		{
+			// the display callback can't query VLC's time itself (see StaticDisplayCallback)
+			const int64 DecoderMilliseconds = FVlc::MediaPlayerGetTime(Player);
+
+			if (DecoderMilliseconds >= 0)
+			{
+				FScopeLock Lock(&CriticalSection);
+				DecoderTime = FTimespan::FromMilliseconds(DecoderMilliseconds);
+			}
+		}
+		else if (State == ELibvlcState::Ended)
+		{
+			FinishDecode(true);
+		}
+		else if ((State == ELibvlcState::Error) || (FPlatformTime::Seconds() - DecodeStartSeconds > MaxSeconds))
+		{
+			FinishDecode(false);
+		}
+	}
+
+	const FChunk* Current = FindChunk(Time);
+
+	if (Current == nullptr)
+	{
+		// the time was sought to, so the chunk that is being decoded ahead is not needed yet
+		if (Decoding.IsValid())
+		{
+			FVlc::MediaPlayerStop(Player);
+			FVlc::MediaPlayerSetMedia(Player, nullptr);
+
+			FScopeLock Lock(&CriticalSection);
+			Decoding.Reset();
+		}
+
+		FTimespan End = Time + (Forward ? VlcMediaReverse::ChunkLength : VlcMediaReverse::EndMargin);
+
+		for (const TSharedRef<FChunk>& Chunk : Chunks)
+		{
+			if ((Chunk->Start > Time) && (Chunk->Start < End))
+			{
+				End = Chunk->Start;
+			}
+		}
+
+		StartDecode(GetChunkStart(Time), End);
+	}
+	else if (!Decoding.IsValid())
+	{
+		// decode ahead in playback direction
+		if (Forward)
+		{
+			if (((Duration == FTimespan::Zero()) || (Current->End < Duration)) && (FindChunk(Current->End) == nullptr))
+			{
+				StartDecode(Current->End, Current->End + VlcMediaReverse::ChunkLength);
+			}
+		}
+		else
+		{
+			FTimespan CurrentStart;
+			{
+				FScopeLock Lock(&CriticalSection);
+				CurrentStart = Current->Start;
+			}
+
+			if ((CurrentStart > FTimespan::Zero()) && (FindChunk(CurrentStart - FTimespan(1)) == nullptr))
+			{
+				StartDecode(GetChunkStart(CurrentStart - FTimespan(1)), CurrentStart);
+			}
+		}
+	}
+
+	Evict(Time);
+}
+
+
+/* FVlcMediaReverse implementation
+ *****************************************************************************/
+
+void FVlcMediaReverse::Evict(FTimespan Time)
+{
+	while (CacheBytes > MaxCacheSize)
+	{
+		// release chunks that were already played first, then the ones farthest ahead
+		int32 EvictIndex = INDEX_NONE;
+		double EvictScore = -1.0;
+
+		for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+		{
+			const FChunk& Chunk = *Chunks[ChunkIndex];
+
+			if ((Chunk.Start <= Time) && (Time < Chunk.End))
+			{
+				continue;
+			}
+
+			const bool Played = Forward ? (Chunk.End <= Time) : (Chunk.Start > Time);
+			const FTimespan Distance = (Chunk.Start > Time) ? (Chunk.Start - Time) : (Time - Chunk.End);
+			const double Score = (Played ? 1.0e9 : 0.0) + Distance.GetTotalSeconds();
+
+			if (Score > EvictScore)
+			{
+				EvictIndex = ChunkIndex;
+				EvictScore = Score;
+			}
+		}
+
+		if (EvictIndex == INDEX_NONE)
+		{
+			break;
+		}
+
+		CacheBytes -= Chunks[EvictIndex]->Bytes;
+		Chunks.RemoveAtSwap(EvictIndex);
+	}
+}
+
+
+int32 FVlcMediaReverse::FindFrame(const FChunk& Chunk, FTimespan Time)
+{
+	for (int32 FrameIndex = Chunk.Frames.Num() - 1; FrameIndex >= 0; --FrameIndex)
+	{
+		if (Chunk.Frames[FrameIndex]->GetTime() <= Time)
+		{
+			return FrameIndex;
+		}
+	}
+
+	return (Chunk.Frames.Num() > 0) ? 0 : INDEX_NONE;
+}
+
+
+FTimespan FVlcMediaReverse::GetChunkStart(FTimespan Last)
+{
+	FVlcMediaKeyframe Keyframe;
+
+	if ((KeyframeIndex != nullptr) && KeyframeIndex->FindKeyframe(Last, Keyframe))
+	{
+		return Keyframe.Time;
+	}
+
+	return FMath::Max(FTimespan::Zero(), Last - VlcMediaReverse::ChunkLength);
+}
+
+
+FVlcMediaReverse::FChunk* FVlcMediaReverse::FindChunk(FTimespan Time) const
+{
+	for (const TSharedRef<FChunk>& Chunk : Chunks)
+	{
+		if ((Chunk->Start <= Time) && (Time < Chunk->End))
+		{
+			return &Chunk.Get();
+		}
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (Decoding.IsValid() && (DecodingStart <= Time) && (Time < Decoding->End))
+	{
+		return Decoding.Get();
+	}
+
+	return nullptr;
+}
+
+
+void FVlcMediaReverse::FinishDecode(bool Succeeded)
+{
+	// stopping waits for the decoder threads, so the chunk is no longer written to afterwards
+	FVlc::MediaPlayerStop(Player);
+	FVlc::MediaPlayerSetMedia(Player, nullptr);
+
+	TSharedPtr<FChunk> Chunk;
+	{
+		FScopeLock Lock(&CriticalSection);
+		Chunk = Decoding;
+		Decoding.Reset();
+	}
+
+	DecodeSeconds += FPlatformTime::Seconds() - DecodeStartSeconds;
+
+	if (!Succeeded)
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Reverse %p: Failed to decode %s to %s of %s (%i frames)"), this, *DecodingStart.ToString(), *Chunk->End.ToString(), *Location, Chunk->Frames.Num());
+	}
+
+	// chunks that failed are kept as well, so that playback skips over them instead of stalling
+	Chunk->Complete = true;
+	CacheBytes += Chunk->Bytes;
+	DecodedFrames += Chunk->Frames.Num();
+	Chunks.Add(Chunk.ToSharedRef());
+}
+
+
+bool FVlcMediaReverse::StartDecode(FTimespan Start, FTimespan End)
+{
+	TSharedRef<FChunk> Chunk = MakeShared<FChunk>();
+	{
+		Chunk->Bytes = 0;
+		Chunk->Complete = false;
+		Chunk->End = End;
+		Chunk->Start = Start;
+	}
+
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		Decoding = Chunk;
+		DecoderTime = FTimespan::MinValue();
+		DecoderTimeOrigin = FTimespan::MinValue();
+		DecodingStart = Start;
+		PreviousFrameTime = FTimespan::MinValue();
+	}
+
+	DecodeStartSeconds = FPlatformTime::Seconds();
+
+	FLibvlcMedia* Media = LocationIsPath
+		? FVlc::MediaNewPath(VlcInstance, TCHAR_TO_UTF8(*Location))
+		: FVlc::MediaNewLocation(VlcInstance, TCHAR_TO_ANSI(*Location));
+
+	if (Media == nullptr)
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to open media for reverse playback: %s (%s)"), *Location, ANSI_TO_TCHAR(FVlc::Errmsg()));
+		FinishDecode(false);
+
+		return false;
+	}
+
+	FVlc::MediaAddOption(Media, ":no-audio");
+	FVlc::MediaAddOption(Media, ":no-spu");
+	FVlc::MediaAddOption(Media, ":avcodec-hurry-up=0"); // decoding faster than real-time must not drop frames
+	FVlc::MediaAddOption(Media, ":no-drop-late-frames");
+	FVlc::MediaAddOption(Media, TCHAR_TO_ANSI(*FString::Printf(TEXT(":start-time=%.3f"), Start.GetTotalSeconds())));
+	FVlc::MediaAddOption(Media, TCHAR_TO_ANSI(*FString::Printf(TEXT(":stop-time=%.3f"), End.GetTotalSeconds())));
+
+	FVlc::MediaPlayerSetMedia(Player, Media);
+	FVlc::MediaRelease(Media);
+
+	if (FVlc::MediaPlayerPlay(Player) == -1)
+	{
+		FinishDecode(false);
+		return false;
+	}
+
+	FVlc::MediaPlayerSetRate(Player, VlcMediaReverse::DecodeRate);
+
+	UE_LOG(LogVlcMedia, VeryVerbose, TEXT("Reverse %p: Decoding %s to %s"), this, *Start.ToString(), *End.ToString());
+
+	return true;
+}
+
+
+/* FVlcMediaReverse callbacks
+ *****************************************************************************/
+
+void FVlcMediaReverse::StaticDisplayCallback(void* Opaque, void* Picture)
+{
+	auto Reverse = (FVlcMediaReverse*)Opaque;
+
+	if ((Reverse == nullptr) || (Picture == nullptr))
+	{
+		return;
+	}
+
+	// frames that are not kept return to the pool when this goes out of scope
+	auto Sample = Reverse->SamplePool->ToShared((FVlcMediaTextureSample*)Picture);
+
+	FScopeLock Lock(&Reverse->CriticalSection);
+
+	if (!Reverse->Decoding.IsValid())
+	{
+		return;
+	}
+
+	FTimespan Time = Reverse->DecodingStart;
+
+	if (Reverse->PreviousFrameTime != FTimespan::MinValue())
+	{
+		// late frames are displayed rather than dropped, so each frame follows the previous one
+		Time = Reverse->PreviousFrameTime + Reverse->FrameDuration;
+	}
+
+	// vmem pictures carry no timestamps, and querying VLC's time here may deadlock, because stopping the
+	// decoder waits for the display thread, so frames are counted, and the play time that Tick polled tells
+	// how far the stream actually advanced (the decoder is ahead of the display, but by a steady amount)
+	if (Reverse->DecoderTime != FTimespan::MinValue())
+	{
+		if (Reverse->DecoderTimeOrigin == FTimespan::MinValue())
+		{
+			Reverse->DecoderTimeOrigin = Reverse->DecoderTime;
+			Reverse->FrameTimeOrigin = Time;
+		}
+		else if (Reverse->FrameDuration > FTimespan::Zero())
+		{
+			const FTimespan StreamTime = Reverse->FrameTimeOrigin + (Reverse->DecoderTime - Reverse->DecoderTimeOrigin);
+
+			if (StreamTime > Time)
+			{
+				// frames are missing from the stream, so snap to the frame at VLC's time
+				Time += Reverse->FrameDuration * (double)((StreamTime - Time).GetTicks() / Reverse->FrameDuration.GetTicks());
+			}
+		}
+	}
+
+	Reverse->PreviousFrameTime = Time;
+
+	FChunk& Chunk = *Reverse->Decoding;
+
+	if (Time >= Chunk.End)
+	{
+		return;
+	}
+
+	Sample->SetTime(Time);
+	Chunk.Frames.Add(Sample);
+	Chunk.Bytes += Sample->GetStride() * Sample->GetDim().Y;
+
+	// GOPs that are much longer than average may still not fit, in which case only their most recent frames are kept
+	while ((Chunk.Bytes > Reverse->MaxCacheSize / 2) && (Chunk.Frames.Num() > 1))
+	{
+		Chunk.Bytes -= Chunk.Frames[0]->GetStride() * Chunk.Frames[0]->GetDim().Y;
+		Chunk.Frames.RemoveAt(0);
+		Chunk.Start = Chunk.Frames[0]->GetTime();
+	}
+}
+
+
+void* FVlcMediaReverse::StaticLockCallback(void* Opaque, void** Planes)
+{
+	auto Reverse = (FVlcMediaReverse*)Opaque;
+	check(Reverse != nullptr);
+
+	FMemory::Memzero(Planes, FVlc::MaxPlanes * sizeof(void*));
+
+	auto Sample = Reverse->SamplePool->Acquire();
+
+	if ((Sample == nullptr) || !Sample->Initialize(Reverse->Dim, Reverse->Dim, EMediaTextureSampleFormat::CharBGRA, Reverse->Dim.X * 4, Reverse->FrameDuration))
+	{
+		// VLC currently requires a valid buffer or it will crash
+		Planes[0] = FMemory::Malloc(Reverse->Dim.X * 4 * Reverse->Dim.Y, 32);
+		return nullptr;
+	}
+
+	Planes[0] = Sample->GetMutableBuffer();
+
+	return Sample;
+}
+
+
+unsigned FVlcMediaReverse::StaticSetupCallback(void** Opaque, char* Chroma, unsigned* Width, unsigned* Height, unsigned* Pitches, unsigned* Lines)
+{
+	auto Reverse = *(FVlcMediaReverse**)Opaque;
+
+	if ((Reverse == nullptr) || (*Width == 0) || (*Height == 0))
+	{
+		return 0;
+	}
+
+	const float Fps = FVlc::MediaPlayerGetFps(Reverse->Player);
+	Reverse->FrameDuration = FTimespan::FromSeconds(1.0 / ((Fps > 0.0f) ? Fps : 30.0f));
+
+	// let VLC scale the frames to the player's output size
+	float Scale = (Reverse->MaxOutputDim > 0) ? FMath::Min(1.0f, (float)Reverse->MaxOutputDim / FMath::Max(*Width, *Height)) : 1.0f;
+
+	// the chunk that is played and the one decoded ahead must both fit into the cache, so scale down further if needed
+	const int64 FramesPerChunk = (Reverse->ExpectedChunkLength + VlcMediaReverse::EndMargin).GetTicks() / Reverse->FrameDuration.GetTicks() + 1;
+	const double MaxFrameBytes = (double)(Reverse->MaxCacheSize / 2) / FramesPerChunk;
+	const double FrameBytes = FMath::Square(Scale) * *Width * *Height * 4.0;
+
+	if (FrameBytes > MaxFrameBytes)
+	{
+		Scale *= FMath::Sqrt(MaxFrameBytes / FrameBytes);
+	}
+
+	Reverse->Dim.X = FMath::Max(1, FMath::FloorToInt(*Width * Scale));
+	Reverse->Dim.Y = FMath::Max(1, FMath::FloorToInt(*Height * Scale));
+
+	if (FrameBytes > MaxFrameBytes)
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Reverse %p: Decoding at %ix%i, so that %i frames fit into half of the cache"), Reverse, Reverse->Dim.X, Reverse->Dim.Y, (int32)FramesPerChunk);
+	}
+
+	FMemory::Memcpy(Chroma, "RV32", 4);
+
+	*Width = Reverse->Dim.X;
+	*Height = Reverse->Dim.Y;
+	Pitches[0] = Reverse->Dim.X * 4;
+	Lines[0] = Reverse->Dim.Y;
+
+	return 1;
+}
+
+
+void FVlcMediaReverse::StaticUnlockCallback(void* /*Opaque*/, void* Picture, void* const* Planes)
+{
+	// discard temporary buffer for VLC crash workaround
+	if ((Picture == nullptr) && (Planes != nullptr) && (Planes[0] != nullptr))
+	{
+		FMemory::Free(Planes[0]);
+	}
+}
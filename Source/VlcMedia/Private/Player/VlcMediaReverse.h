@@ -0,0 +1,289 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/SharedPointer.h"
+
+class FVlcMediaKeyframeIndex;
+class FVlcMediaTextureSample;
+class FVlcMediaTextureSamplePool;
+
+struct FLibvlcInstance;
+struct FLibvlcMediaPlayer;
+
+
+/**
+ * Implements reverse playback on top of a cache of decoded GOPs.
+ *
+ * VLC can only decode forward, so a separate VLC player decodes the media
+ * one group of pictures (GOP) at a time, from its key frame up to the start
+ * of the GOP that was decoded before it. The decoded frames are kept in
+ * pooled BGRA samples, and the player emits them in reverse order. While
+ * one GOP is played, the one before it is decoded ahead. Decoded GOPs are
+ * kept until the cache exceeds its size limit, so that changing directions
+ * or scrubbing nearby is cheap.
+ *
+ * Without a key frame index, GOPs are approximated by fixed length chunks,
+ * which VLC decodes from the nearest preceding key frame.
+ *
+ * Frames are decoded at a lower resolution if two chunks of average length
+ * wouldn't fit into the cache otherwise. GOPs that are still too long keep
+ * only their most recent frames, so stepping backward past the dropped ones
+ * decodes the GOP again.
+ *
+ * The cache also serves frame stepping, in which case it decodes ahead in
+ * whichever direction the time last moved.
+ */
+class FVlcMediaReverse
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaReverse();
+
+	/** Destructor. */
+	~FVlcMediaReverse();
+
+public:
+
+	/**
+	 * Get the decoded frame for the specified time.
+	 *
+	 * @param Time The playback time.
+	 * @param OutSample Will contain the frame that is displayed at the specified time.
+	 * @return true if the frame is available, false if it still needs to be decoded.
+	 * @see Tick
+	 */
+	bool FetchFrame(FTimespan Time, TSharedPtr<FVlcMediaTextureSample, ESPMode::ThreadSafe>& OutSample);
+
+	/**
+	 * Get the reverse playback statistics.
+	 *
+	 * @return Statistics string (one indented line per value).
+	 */
+	FString GetStats() const;
+
+	/**
+	 * Check whether reverse playback is active.
+	 *
+	 * @return true if active, false otherwise.
+	 */
+	bool IsActive() const
+	{
+		return (Player != nullptr);
+	}
+
+	/**
+	 * Start decoding for reverse playback.
+	 *
+	 * @param VlcInstance The LibVLC instance to use.
+	 * @param Location The media file path or URL.
+	 * @param IsPath Whether the location is a local file path.
+	 * @param InKeyframeIndex Key frame index of the media (optional).
+	 * @param InDuration Duration of the media (zero if unknown).
+	 * @param InMaxOutputDim The maximum width or height of the decoded frames (0 = source size).
+	 * @param InMaxCacheSize Maximum size of the decoded frame cache (in bytes).
+	 * @return true on success, false otherwise.
+	 * @see Stop
+	 */
+	bool Start(FLibvlcInstance* VlcInstance, const FString& Location, bool IsPath, FVlcMediaKeyframeIndex* InKeyframeIndex, FTimespan InDuration, int32 InMaxOutputDim, SIZE_T InMaxCacheSize);
+
+	/**
+	 * Find the frame that is a number of frames away from the one displayed at the specified time.
+	 *
+	 * Steps are counted through the cached frames, also across adjacent chunks.
+	 *
+	 * @param Time The current playback time.
+	 * @param NumFrames Number of frames to step (negative = backward).
+	 * @param FrameDuration Duration of a frame, which is used to estimate the time of frames that aren't cached.
+	 * @param OutTime Will contain the time of the target frame, or an estimate if it isn't cached yet.
+	 * @return true if the target frame is cached, false if it still needs to be decoded.
+	 * @see FetchFrame
+	 */
+	bool StepFrames(FTimespan Time, int32 NumFrames, FTimespan FrameDuration, FTimespan& OutTime) const;
+
+	/**
+	 * Stop decoding and release all cached frames.
+	 *
+	 * @see Start
+	 */
+	void Stop();
+
+	/**
+	 * Schedule decoding of the GOPs needed around the specified time.
+	 *
+	 * @param Time The current playback time.
+	 */
+	void Tick(FTimespan Time);
+
+protected:
+
+	/** A range of decoded frames. */
+	struct FChunk
+	{
+		/** Total size of the frame buffers (in bytes). */
+		SIZE_T Bytes;
+
+		/** Whether decoding finished. */
+		bool Complete;
+
+		/** Time at which the chunk ends (exclusive). */
+		FTimespan End;
+
+		/** The decoded frames, in presentation order. */
+		TArray<TSharedRef<FVlcMediaTextureSample, ESPMode::ThreadSafe>> Frames;
+
+		/** Time of the first frame (changes while decoding, so read it under the critical section until the chunk is complete). */
+		FTimespan Start;
+	};
+
+	/**
+	 * Abort or complete the current decode.
+	 *
+	 * @param Succeeded Whether the decoder reached the end of the chunk.
+	 */
+	void FinishDecode(bool Succeeded);
+
+	/**
+	 * Find a decoded or decoding chunk that contains the specified time.
+	 *
+	 * @param Time The time to find.
+	 * @return The chunk, or nullptr if none.
+	 */
+	FChunk* FindChunk(FTimespan Time) const;
+
+	/**
+	 * Find the frame that is displayed at the specified time.
+	 *
+	 * @param Chunk The chunk that contains the time.
+	 * @param Time The time to find.
+	 * @return Index of the last frame at or before the time (or the first frame), or INDEX_NONE if the chunk is empty.
+	 */
+	static int32 FindFrame(const FChunk& Chunk, FTimespan Time);
+
+	/**
+	 * Get the time at which to start decoding a chunk.
+	 *
+	 * @param Last The last time that the chunk must contain.
+	 * @return The time of the preceding key frame, or an approximation if the key frames are not indexed.
+	 */
+	FTimespan GetChunkStart(FTimespan Last);
+
+	/**
+	 * Release chunks until the cache fits into its size limit.
+	 *
+	 * @param Time The current playback time (its chunk is kept).
+	 */
+	void Evict(FTimespan Time);
+
+	/**
+	 * Start decoding a chunk.
+	 *
+	 * @param Start The time at which the chunk starts.
+	 * @param End The time at which the chunk ends.
+	 * @return true on success, false otherwise.
+	 */
+	bool StartDecode(FTimespan Start, FTimespan End);
+
+private:
+
+	/** Handles video display callbacks from VLC. */
+	static void StaticDisplayCallback(void* Opaque, void* Picture);
+
+	/** Handles video lock callbacks from VLC. */
+	static void* StaticLockCallback(void* Opaque, void** Planes);
+
+	/** Handles video format setup callbacks from VLC. */
+	static unsigned StaticSetupCallback(void** Opaque, char* Chroma, unsigned* Width, unsigned* Height, unsigned* Pitches, unsigned* Lines);
+
+	/** Handles video unlock callbacks from VLC. */
+	static void StaticUnlockCallback(void* Opaque, void* Picture, void* const* Planes);
+
+private:
+
+	/** Total size of all cached frames (in bytes). */
+	SIZE_T CacheBytes;
+
+	/** Decoded chunks. */
+	TArray<TSharedRef<FChunk>> Chunks;
+
+	/** Synchronizes access to the decoding chunk, including its start time, from the VLC display thread. */
+	mutable FCriticalSection CriticalSection;
+
+	/** Total wall clock time spent decoding (in seconds). */
+	double DecodeSeconds;
+
+	/** The chunk being decoded (if any). */
+	TSharedPtr<FChunk> Decoding;
+
+	/** Time at which the chunk being decoded was requested to start. */
+	FTimespan DecodingStart;
+
+	/** Number of frames that were decoded. */
+	int32 DecodedFrames;
+
+	/** Time when the current decode started (in seconds). */
+	double DecodeStartSeconds;
+
+	/** Most recent play time of the decoder, as polled by Tick (MinValue = not known yet). */
+	FTimespan DecoderTime;
+
+	/** Decoder time when the frame at FrameTimeOrigin was displayed (MinValue = none yet). */
+	FTimespan DecoderTimeOrigin;
+
+	/** Dimensions of the decoded frames. */
+	FIntPoint Dim;
+
+	/** Duration of the media (zero if unknown). */
+	FTimespan Duration;
+
+	/** Expected length of the decoded chunks, i.e. the average GOP length (used to fit the frames into the cache). */
+	FTimespan ExpectedChunkLength;
+
+	/** Whether the time last moved forward. */
+	bool Forward;
+
+	/** Duration of a single frame. */
+	FTimespan FrameDuration;
+
+	/** Time of the first frame that was displayed once the decoder time was known. */
+	FTimespan FrameTimeOrigin;
+
+	/** Key frame index of the media (optional). */
+	FVlcMediaKeyframeIndex* KeyframeIndex;
+
+	/** Time of the most recently fetched frame. */
+	FTimespan LastFetchTime;
+
+	/** Time of the most recent tick. */
+	FTimespan LastTickTime;
+
+	/** The media file path or URL. */
+	FString Location;
+
+	/** Whether the location is a local file path. */
+	bool LocationIsPath;
+
+	/** Maximum size of the frame cache (in bytes). */
+	SIZE_T MaxCacheSize;
+
+	/** The maximum width or height of the decoded frames. */
+	int32 MaxOutputDim;
+
+	/** The VLC media player object that decodes the chunks. */
+	FLibvlcMediaPlayer* Player;
+
+	/** Time of the frame that the decoder displayed before the current one. */
+	FTimespan PreviousFrameTime;
+
+	/** Total playback time in reverse direction. */
+	FTimespan ReversedTime;
+
+	/** The pool of frame samples. */
+	FVlcMediaTextureSamplePool* SamplePool;
+
+	/** The LibVLC instance. */
+	FLibvlcInstance* VlcInstance;
+};
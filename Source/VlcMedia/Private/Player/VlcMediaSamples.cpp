@@ -0,0 +1,121 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaSamples.h"
+#include "VlcMediaPrivate.h"
+
+#include "HAL/PlatformTime.h"
+
+#include "Vlc.h"
+#include "VlcMediaAudioSample.h"
+#include "VlcMediaTextureSample.h"
+
+
+const double FVlcMediaSamples::LatencyWindowSeconds = 5.0;
+
+
+namespace VlcMediaSamples
+{
+	/** Time range that accepts all samples. */
+	const TRange<FTimespan> AllTime(FTimespan::MinValue(), FTimespan::MaxValue());
+}
+
+
+/* FVlcMediaSamples structors
+ *****************************************************************************/
+
+FVlcMediaSamples::FVlcMediaSamples()
+	: ActiveLatencies(0)
+	, LowLatency(false)
+	, WindowStartTime(FPlatformTime::Seconds())
+{ }
+
+
+/* FVlcMediaSamples interface
+ *****************************************************************************/
+
+void FVlcMediaSamples::ResetLatencies()
+{
+	Latencies[0].Reset();
+	Latencies[1].Reset();
+
+	WindowStartTime = FPlatformTime::Seconds();
+}
+
+
+void FVlcMediaSamples::UpdateLatencies()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	if (Now - WindowStartTime < LatencyWindowSeconds)
+	{
+		return;
+	}
+
+	// samples recorded concurrently with the swap may end up in either window
+	const int32 NextLatencies = 1 - ActiveLatencies;
+
+	Latencies[NextLatencies].Reset();
+	ActiveLatencies = NextLatencies;
+	WindowStartTime = Now;
+}
+
+
+/* IMediaSamples interface
+ *****************************************************************************/
+
+bool FVlcMediaSamples::FetchAudio(TRange<FTimespan> TimeRange, TSharedPtr<IMediaAudioSample, ESPMode::ThreadSafe>& OutSample)
+{
+	if (!FMediaSamples::FetchAudio(LowLatency ? VlcMediaSamples::AllTime : TimeRange, OutSample))
+	{
+		return false;
+	}
+
+	const FVlcMediaAudioSample* AudioSample = static_cast<const FVlcMediaAudioSample*>(OutSample.Get());
+	FVlcMediaSampleLatencies& Window = Latencies[ActiveLatencies];
+
+	Window.AudioQueueResidency.AddCycles(FPlatformTime::Cycles64() - AudioSample->GetEnqueueCycles());
+
+	// VLC expects the sample to be audible at its presentation timestamp
+	const int64 Delay = FVlc::Delay(AudioSample->GetPresentationTimestamp());
+
+	if (Delay >= 0)
+	{
+		Window.AudioPresentationLead.Add((uint64)Delay);
+	}
+	else
+	{
+		Window.AudioPresentationLag.Add((uint64)-Delay);
+	}
+
+	return true;
+}
+
+
+bool FVlcMediaSamples::FetchVideo(TRange<FTimespan> TimeRange, TSharedPtr<IMediaTextureSample, ESPMode::ThreadSafe>& OutSample)
+{
+	if (!FMediaSamples::FetchVideo(LowLatency ? VlcMediaSamples::AllTime : TimeRange, OutSample))
+	{
+		return false;
+	}
+
+	// skip to the newest frame
+	if (LowLatency)
+	{
+		TSharedPtr<IMediaTextureSample, ESPMode::ThreadSafe> NewerSample;
+
+		while (FMediaSamples::FetchVideo(VlcMediaSamples::AllTime, NewerSample))
+		{
+			OutSample = NewerSample;
+			NumSkippedVideo.Increment();
+		}
+	}
+
+	const FVlcMediaTextureSample* VideoSample = static_cast<const FVlcMediaTextureSample*>(OutSample.Get());
+	FVlcMediaSampleLatencies& Window = Latencies[ActiveLatencies];
+	const uint64 Cycles = FPlatformTime::Cycles64();
+
+	Window.VideoQueueResidency.AddCycles(Cycles - VideoSample->GetEnqueueCycles());
+	Window.VideoTotal.AddCycles(Cycles - VideoSample->GetLockCycles());
+
+	return true;
+}
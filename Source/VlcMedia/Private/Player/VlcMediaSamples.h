@@ -0,0 +1,156 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "MediaSamples.h"
+
+#include "VlcMediaHistogram.h"
+
+
+/**
+ * Latency histograms for samples passing through the output queues.
+ */
+struct FVlcMediaSampleLatencies
+{
+	/** Time between the play callback and the audio sample being fetched. */
+	FVlcMediaHistogram AudioQueueResidency;
+
+	/** Time by which audio samples were fetched before VLC's presentation timestamp. */
+	FVlcMediaHistogram AudioPresentationLead;
+
+	/** Time by which audio samples were fetched after VLC's presentation timestamp. */
+	FVlcMediaHistogram AudioPresentationLag;
+
+	/** Time between the decoder finishing a frame and VLC displaying it. */
+	FVlcMediaHistogram VideoDecodeToEnqueue;
+
+	/** Time between the display callback and the video sample being fetched. */
+	FVlcMediaHistogram VideoQueueResidency;
+
+	/** Time between the lock callback and the video sample being fetched. */
+	FVlcMediaHistogram VideoTotal;
+
+public:
+
+	/** Remove all samples from all histograms. */
+	void Reset()
+	{
+		AudioQueueResidency.Reset();
+		AudioPresentationLead.Reset();
+		AudioPresentationLag.Reset();
+		VideoDecodeToEnqueue.Reset();
+		VideoQueueResidency.Reset();
+		VideoTotal.Reset();
+	}
+};
+
+
+/**
+ * Media sample queues that measure how long samples take to be consumed.
+ *
+ * Latencies are collected over rolling windows. The histograms returned by
+ * GetLatencies always hold the most recently completed window, so that the
+ * reported numbers reflect current conditions rather than the whole session.
+ */
+class FVlcMediaSamples
+	: public FMediaSamples
+{
+public:
+
+	/** Length of a latency window (in seconds). */
+	static const double LatencyWindowSeconds;
+
+public:
+
+	/** Default constructor. */
+	FVlcMediaSamples();
+
+public:
+
+	/**
+	 * Get the latencies of the most recently completed window.
+	 *
+	 * @return Latency histograms.
+	 * @see UpdateLatencies
+	 */
+	const FVlcMediaSampleLatencies& GetLatencies() const
+	{
+		return Latencies[1 - ActiveLatencies];
+	}
+
+	/**
+	 * Get the number of video samples that were skipped in low-latency mode.
+	 *
+	 * @return Number of skipped samples.
+	 * @see SetLowLatency
+	 */
+	int32 GetNumSkippedVideo() const
+	{
+		return NumSkippedVideo.GetValue();
+	}
+
+	/**
+	 * Record the decoder latency of a video sample that is about to be enqueued.
+	 *
+	 * @param DecodeCycles Time at which the decoder finished the sample (in cycles).
+	 * @param EnqueueCycles Time at which the sample is enqueued (in cycles).
+	 */
+	void RecordVideoDecode(uint64 DecodeCycles, uint64 EnqueueCycles)
+	{
+		if ((DecodeCycles != 0) && (EnqueueCycles >= DecodeCycles))
+		{
+			Latencies[ActiveLatencies].VideoDecodeToEnqueue.AddCycles(EnqueueCycles - DecodeCycles);
+		}
+	}
+
+	/** Discard all collected latencies. */
+	void ResetLatencies();
+
+	/**
+	 * Enable or disable low-latency mode.
+	 *
+	 * In low-latency mode, samples are handed out as soon as they are queued,
+	 * regardless of the requested time range, and older video samples are
+	 * skipped in favor of the newest one.
+	 *
+	 * @param Enabled Whether low-latency mode is enabled.
+	 */
+	void SetLowLatency(bool Enabled)
+	{
+		LowLatency = Enabled;
+		NumSkippedVideo.Reset();
+	}
+
+	/**
+	 * Start a new latency window if the current one expired.
+	 *
+	 * @see GetLatencies
+	 */
+	void UpdateLatencies();
+
+public:
+
+	//~ IMediaSamples interface
+
+	virtual bool FetchAudio(TRange<FTimespan> TimeRange, TSharedPtr<IMediaAudioSample, ESPMode::ThreadSafe>& OutSample) override;
+	virtual bool FetchVideo(TRange<FTimespan> TimeRange, TSharedPtr<IMediaTextureSample, ESPMode::ThreadSafe>& OutSample) override;
+
+private:
+
+	/** Index of the latency window being collected. */
+	volatile int32 ActiveLatencies;
+
+	/** Latency histograms for the current and previous windows. */
+	FVlcMediaSampleLatencies Latencies[2];
+
+	/** Whether low-latency mode is enabled. */
+	bool LowLatency;
+
+	/** Number of video samples skipped in low-latency mode (fetched and read on different threads). */
+	FThreadSafeCounter NumSkippedVideo;
+
+	/** Time at which the current latency window started (in seconds). */
+	double WindowStartTime;
+};
@@ -3,6 +3,9 @@
 #include "VlcMediaSource.h"
 #include "VlcMediaPrivate.h"
 
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+
 #include "Vlc.h"
 
 
@@ -10,7 +13,8 @@
 *****************************************************************************/
 
 FVlcMediaSource::FVlcMediaSource(FLibvlcInstance* InVlcInstance)
-	: Media(nullptr)
+	: Duration(FTimespan::Zero())
+	, Media(nullptr)
 	, VlcInstance(InVlcInstance)
 { }
 
@@ -20,19 +24,19 @@ FVlcMediaSource::FVlcMediaSource(FLibvlcInstance* InVlcInstance)
 
 FTimespan FVlcMediaSource::GetDuration() const
 {
-	if (Media == nullptr)
+	if ((Media == nullptr) || (Duration > FTimespan::Zero()))
 	{
-		return FTimespan::Zero();
+		return Duration;
 	}
 
-	int64 Duration = FVlc::MediaGetDuration(Media);
+	const int64 MediaDuration = FVlc::MediaGetDuration(Media);
 
-	if (Duration < 0)
+	if (MediaDuration > 0)
 	{
-		return FTimespan::Zero();
+		Duration = FTimespan(MediaDuration * ETimespan::TicksPerMillisecond);
 	}
 
-	return FTimespan(Duration * ETimespan::TicksPerMillisecond);
+	return Duration;
 }
 
 
@@ -45,7 +49,7 @@ FLibvlcMedia* FVlcMediaSource::OpenArchive(const TSharedRef<FArchive, ESPMode::T
 		Data = Archive;
 		Media = FVlc::MediaNewCallbacks(
 			VlcInstance,
-			nullptr,
+			&FVlcMediaSource::HandleMediaOpen,
 			&FVlcMediaSource::HandleMediaRead,
 			&FVlcMediaSource::HandleMediaSeek,
 			&FVlcMediaSource::HandleMediaClose,
@@ -67,6 +71,35 @@ FLibvlcMedia* FVlcMediaSource::OpenArchive(const TSharedRef<FArchive, ESPMode::T
 }
 
 
+FLibvlcMedia* FVlcMediaSource::OpenPath(const FString& FilePath, const FString& OriginalUrl)
+{
+	check(Media == nullptr);
+
+	// the physical platform file doesn't see pak files or other virtual file systems
+	const FString PhysicalPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*FilePath);
+
+	if (!IPlatformFile::GetPlatformPhysical().FileExists(*PhysicalPath))
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Media file is not on disk, streaming it instead: %s"), *FilePath);
+		return nullptr;
+	}
+
+	Media = FVlc::MediaNewPath(VlcInstance, TCHAR_TO_UTF8(*PhysicalPath));
+
+	if (Media == nullptr)
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to open media from path: %s (%s)"), *PhysicalPath, ANSI_TO_TCHAR(FVlc::Errmsg()));
+	}
+	else
+	{
+		CurrentUrl = OriginalUrl;
+		Path = PhysicalPath;
+	}
+
+	return Media;
+}
+
+
 FLibvlcMedia* FVlcMediaSource::OpenUrl(const FString& Url)
 {
 	check(Media == nullptr);
@@ -86,6 +119,67 @@ FLibvlcMedia* FVlcMediaSource::OpenUrl(const FString& Url)
 }
 
 
+void FVlcMediaSource::AddOption(const FString& Option, bool Keep)
+{
+	if (Media == nullptr)
+	{
+		return;
+	}
+
+	FVlc::MediaAddOption(Media, TCHAR_TO_ANSI(*Option));
+
+	if (Keep)
+	{
+		Options.Add(Option);
+	}
+}
+
+
+bool FVlcMediaSource::Reopen(const TArray<FString>& ExtraOptions)
+{
+	if (Media == nullptr)
+	{
+		return false;
+	}
+
+	FLibvlcMedia* NewMedia = nullptr;
+
+	if (Data.IsValid())
+	{
+		NewMedia = FVlc::MediaNewCallbacks(VlcInstance, &FVlcMediaSource::HandleMediaOpen, &FVlcMediaSource::HandleMediaRead, &FVlcMediaSource::HandleMediaSeek, &FVlcMediaSource::HandleMediaClose, this);
+	}
+	else if (!Path.IsEmpty())
+	{
+		NewMedia = FVlc::MediaNewPath(VlcInstance, TCHAR_TO_UTF8(*Path));
+	}
+	else
+	{
+		NewMedia = FVlc::MediaNewLocation(VlcInstance, TCHAR_TO_ANSI(*CurrentUrl));
+	}
+
+	if (NewMedia == nullptr)
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to reopen media: %s (%s)"), *CurrentUrl, ANSI_TO_TCHAR(FVlc::Errmsg()));
+		return false;
+	}
+
+	for (const FString& Option : Options)
+	{
+		FVlc::MediaAddOption(NewMedia, TCHAR_TO_ANSI(*Option));
+	}
+
+	for (const FString& Option : ExtraOptions)
+	{
+		FVlc::MediaAddOption(NewMedia, TCHAR_TO_ANSI(*Option));
+	}
+
+	FVlc::MediaRelease(Media);
+	Media = NewMedia;
+
+	return true;
+}
+
+
 void FVlcMediaSource::Close()
 {
 	if (Media != nullptr)
@@ -96,6 +190,11 @@ void FVlcMediaSource::Close()
 
 	Data.Reset();
 	CurrentUrl.Reset();
+	Duration = FTimespan::Zero();
+	Options.Reset();
+	Path.Reset();
+	ReadTimes.Reset();
+	SeekTimes.Reset();
 }
 
 
@@ -105,12 +204,14 @@ void FVlcMediaSource::Close()
 int FVlcMediaSource::HandleMediaOpen(void* Opaque, void** OutData, uint64* OutSize)
 {
 	auto Reader = (FVlcMediaSource*)Opaque;
+	*OutData = Opaque;
 
 	if ((Reader == nullptr) || !Reader->Data.IsValid())
 	{
 		return 0;
 	}
 
+	// the stream size enables position based seeking
 	*OutSize = Reader->Data->TotalSize();
 
 	return 0;
@@ -119,6 +220,8 @@ int FVlcMediaSource::HandleMediaOpen(void* Opaque, void** OutData, uint64* OutSi
 
 SSIZE_T FVlcMediaSource::HandleMediaRead(void* Opaque, void* Buffer, SIZE_T Length)
 {
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_MediaRead);
+
 	auto Reader = (FVlcMediaSource*)Opaque;
 
 	if (Reader == nullptr)
@@ -126,6 +229,8 @@ SSIZE_T FVlcMediaSource::HandleMediaRead(void* Opaque, void* Buffer, SIZE_T Leng
 		return -1;
 	}
 
+	FVlcMediaScopedTimer ScopedTimer(Reader->ReadTimes);
+
 	TSharedPtr<FArchive, ESPMode::ThreadSafe> Data = Reader->Data;
 
 	if (!Reader->Data.IsValid())
@@ -153,6 +258,8 @@ SSIZE_T FVlcMediaSource::HandleMediaRead(void* Opaque, void* Buffer, SIZE_T Leng
 
 int FVlcMediaSource::HandleMediaSeek(void* Opaque, uint64 Offset)
 {
+	SCOPE_CYCLE_COUNTER(STAT_VlcMedia_MediaSeek);
+
 	auto Reader = (FVlcMediaSource*)Opaque;
 
 	if (Reader == nullptr)
@@ -160,6 +267,8 @@ int FVlcMediaSource::HandleMediaSeek(void* Opaque, uint64 Offset)
 		return -1;
 	}
 
+	FVlcMediaScopedTimer ScopedTimer(Reader->SeekTimes);
+
 	TSharedPtr<FArchive, ESPMode::ThreadSafe> Data = Reader->Data;
 
 	if (!Reader->Data.IsValid())
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 
+#include "VlcMediaHistogram.h"
+
 
 struct FLibvlcInstance;
 struct FLibvlcMedia;
@@ -31,19 +33,57 @@ public:
 		return Media;
 	}
 
+	/** Get the time spent in archive read callbacks. */
+	const FVlcMediaHistogram& GetReadTimes() const
+	{
+		return ReadTimes;
+	}
+
+	/** Get the time spent in archive seek callbacks. */
+	const FVlcMediaHistogram& GetSeekTimes() const
+	{
+		return SeekTimes;
+	}
+
 	/** Get the URL of the currently open media source. */
 	const FString& GetCurrentUrl() const
 	{
 		return CurrentUrl;
 	}
 
+	/** Whether the media is streamed from an archive rather than opened by URL. */
+	bool IsArchive() const
+	{
+		return Data.IsValid();
+	}
+
+	/** Whether the media is read by VLC from a local file path. */
+	bool IsPath() const
+	{
+		return !Path.IsEmpty();
+	}
+
 	/**
 	 * Get the duration of the media source.
 	 *
+	 * The duration is cached once it is known.
+	 *
 	 * @return Media duration.
+	 * @see SetDuration
 	 */
 	FTimespan GetDuration() const;
 
+	/**
+	 * Set the duration of the media source, i.e. from a previous probe.
+	 *
+	 * @param InDuration The duration to set.
+	 * @see GetDuration
+	 */
+	void SetDuration(FTimespan InDuration)
+	{
+		Duration = InDuration;
+	}
+
 	/**
 	 * Open a media source using the given archive.
 	 *
@@ -51,10 +91,27 @@ public:
 	 *
 	 * @param Archive The archive to read media data from.
 	 * @return The media object.
-	 * @see OpenUrl, Close
+	 * @see OpenPath, OpenUrl, Close
 	 */
 	FLibvlcMedia* OpenArchive(const TSharedRef<FArchive, ESPMode::ThreadSafe>& Archive, const FString& OriginalUrl);
 
+	/**
+	 * Open a media source from a plain file on disk.
+	 *
+	 * VLC then reads the file with its own file access, which avoids the
+	 * archive callbacks and lets VLC prefetch. This fails for files that
+	 * are not physically on disk, such as files in pak files, in which
+	 * case the file must be opened with OpenArchive instead.
+	 *
+	 * You must call Close() if this media source is open prior to calling this method.
+	 *
+	 * @param FilePath The path of the media file.
+	 * @param OriginalUrl The URL that the file was opened from.
+	 * @return The media object, or nullptr if the file is not on disk or couldn't be opened.
+	 * @see OpenArchive, OpenUrl, Close
+	 */
+	FLibvlcMedia* OpenPath(const FString& FilePath, const FString& OriginalUrl);
+
 	/**
 	 * Open a media source from the specified URL.
 	 *
@@ -62,14 +119,38 @@ public:
 	 *
 	 * @param Url The media resource locator.
 	 * @return The media object.
-	 * @see OpenArchive, Close
+	 * @see OpenArchive, OpenPath, Close
 	 */
 	FLibvlcMedia* OpenUrl(const FString& Url);
 
+	/**
+	 * Add an input option to the media source, i.e. ":network-caching=50".
+	 *
+	 * Options must be added before the media is played.
+	 *
+	 * @param Option The option to add.
+	 * @param Keep Whether to add the option again when the media source is reopened.
+	 * @see Reopen
+	 */
+	void AddOption(const FString& Option, bool Keep = true);
+
+	/**
+	 * Recreate the media object of the currently open media source.
+	 *
+	 * LibVLC doesn't allow removing options from a media object, so the media
+	 * is recreated with all options that were added so far, plus the given
+	 * extra options. The previous media object is kept if this fails.
+	 *
+	 * @param ExtraOptions Options to add to the new media object only.
+	 * @return true on success, false otherwise.
+	 * @see AddOption
+	 */
+	bool Reopen(const TArray<FString>& ExtraOptions);
+
 	/**
 	 * Close the media source.
 	 *
-	 * @see OpenArchive, OpenUrl
+	 * @see OpenArchive, OpenPath, OpenUrl
 	 */
 	void Close();
 
@@ -92,12 +173,27 @@ private:
 	/** The file or memory archive to stream from (for local media only). */
 	TSharedPtr<FArchive, ESPMode::ThreadSafe> Data;
 
+	/** Cached media duration (zero if not known yet). */
+	mutable FTimespan Duration;
+
 	/** The media object. */
 	FLibvlcMedia* Media;
 
+	/** Input options added to the media object. */
+	TArray<FString> Options;
+
+	/** Physical path of the media file (for media opened by path only). */
+	FString Path;
+
 	/** Currently opened media. */
 	FString CurrentUrl;
 
+	/** Time spent in read callbacks. */
+	FVlcMediaHistogram ReadTimes;
+
+	/** Time spent in seek callbacks. */
+	FVlcMediaHistogram SeekTimes;
+
 	/** The LibVLC instance. */
 	FLibvlcInstance* VlcInstance;
 };
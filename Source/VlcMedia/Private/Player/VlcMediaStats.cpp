@@ -0,0 +1,85 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaStats.h"
+#include "VlcMediaPrivate.h"
+
+#include "Vlc.h"
+
+
+/* FVlcMediaPlayerStats interface
+ *****************************************************************************/
+
+void FVlcMediaPlayerStats::Assign(const FLibvlcMediaStats& Stats)
+{
+	DecodedAudio = Stats.DecodedAudio;
+	DecodedVideo = Stats.DecodedVideo;
+	DisplayedPictures = Stats.DisplayedPictures;
+	LostPictures = Stats.LostPictures;
+	PlayedAudioBuffers = Stats.PlayedAbuffers;
+	LostAudioBuffers = Stats.LostAbuffers;
+	InputBitrate = Stats.InputBitrate;
+	DemuxBitrate = Stats.DemuxBitrate;
+	DemuxCorrupted = Stats.DemuxCorrupted;
+	DemuxDiscontinuity = Stats.DemuxDiscontinuity;
+	SendBitrate = Stats.SendBitrate;
+	SentBytes = Stats.SentBytes;
+	SentPackets = Stats.SentPackets;
+
+	// unsigned differences stay correct when the counters wrap around
+	InputBytesRead += (uint32)Stats.ReadBytes - (uint32)LibvlcInputBytesRead;
+	DemuxBytesRead += (uint32)Stats.DemuxReadBytes - (uint32)LibvlcDemuxBytesRead;
+	LibvlcInputBytesRead = Stats.ReadBytes;
+	LibvlcDemuxBytesRead = Stats.DemuxReadBytes;
+}
+
+
+void FVlcMediaPlayerStats::RestartMedia()
+{
+	LibvlcDemuxBytesRead = 0;
+	LibvlcInputBytesRead = 0;
+}
+
+
+void FVlcMediaPlayerStats::Reset()
+{
+	FMemory::Memzero(this, sizeof(FVlcMediaPlayerStats));
+}
+
+
+void FVlcMediaPlayerStats::Publish() const
+{
+	INC_DWORD_STAT(STAT_VlcMedia_Players);
+
+	INC_DWORD_STAT_BY(STAT_VlcMedia_DecodedAudio, DecodedAudio);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_DecodedVideo, DecodedVideo);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_DisplayedPictures, DisplayedPictures);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_LostPictures, LostPictures);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_PlayedAudioBuffers, PlayedAudioBuffers);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_LostAudioBuffers, LostAudioBuffers);
+
+	INC_FLOAT_STAT_BY(STAT_VlcMedia_InputBitrate, InputBitrate);
+	INC_FLOAT_STAT_BY(STAT_VlcMedia_DemuxBitrate, DemuxBitrate);
+
+	INC_DWORD_STAT_BY(STAT_VlcMedia_AudioSampleQueue, AudioSampleQueue);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_VideoSampleQueue, VideoSampleQueue);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_AudioSamplePool, AudioSamplePool);
+	INC_DWORD_STAT_BY(STAT_VlcMedia_VideoSamplePool, VideoSamplePool);
+
+	// CSV columns accumulate over all players, like the stat group
+	CSV_CUSTOM_STAT(VlcMedia, Players, 1, ECsvCustomStatOp::Accumulate);
+
+	CSV_CUSTOM_STAT(VlcMedia, DecodedAudio, DecodedAudio, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, DecodedVideo, DecodedVideo, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, DisplayedPictures, DisplayedPictures, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, LostPictures, LostPictures, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, PlayedAudioBuffers, PlayedAudioBuffers, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, LostAudioBuffers, LostAudioBuffers, ECsvCustomStatOp::Accumulate);
+
+	CSV_CUSTOM_STAT(VlcMedia, InputBitrate, InputBitrate, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, DemuxBitrate, DemuxBitrate, ECsvCustomStatOp::Accumulate);
+
+	CSV_CUSTOM_STAT(VlcMedia, AudioSampleQueue, AudioSampleQueue, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, VideoSampleQueue, VideoSampleQueue, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, AudioSamplePool, AudioSamplePool, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(VlcMedia, VideoSamplePool, VideoSamplePool, ECsvCustomStatOp::Accumulate);
+}
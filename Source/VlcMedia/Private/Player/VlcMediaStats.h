@@ -0,0 +1,128 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+
+struct FLibvlcMediaStats;
+
+
+/**
+ * Playback statistics of a VLC media player.
+ *
+ * The decoder, input and demux counters are cumulative for the current media
+ * source, while the sample counters reflect the state at the time of update.
+ */
+struct FVlcMediaPlayerStats
+{
+	/** Number of decoded audio blocks. */
+	int32 DecodedAudio;
+
+	/** Number of decoded video frames. */
+	int32 DecodedVideo;
+
+	/** Number of displayed video frames. */
+	int32 DisplayedPictures;
+
+	/** Number of lost (dropped) video frames. */
+	int32 LostPictures;
+
+	/** Number of played audio buffers. */
+	int32 PlayedAudioBuffers;
+
+	/** Number of lost (dropped) audio buffers. */
+	int32 LostAudioBuffers;
+
+	/** Input bit rate (in kbit/s). */
+	float InputBitrate;
+
+	/** Number of bytes read by the input. */
+	int64 InputBytesRead;
+
+	/** Demuxer bit rate (in kbit/s). */
+	float DemuxBitrate;
+
+	/** Number of bytes read by the demuxer. */
+	int64 DemuxBytesRead;
+
+	/** Number of corrupted demuxer packets. */
+	int32 DemuxCorrupted;
+
+	/** Number of demuxer discontinuities. */
+	int32 DemuxDiscontinuity;
+
+	/** Network send bit rate (in kbit/s). */
+	float SendBitrate;
+
+	/** Number of bytes sent over the network. */
+	int32 SentBytes;
+
+	/** Number of packets sent over the network. */
+	int32 SentPackets;
+
+	/** Number of audio samples waiting in the output queue. */
+	int32 AudioSampleQueue;
+
+	/** Number of video samples waiting in the output queue. */
+	int32 VideoSampleQueue;
+
+	/** Number of idle audio samples in the sample pool. */
+	int32 AudioSamplePool;
+
+	/** Number of idle video samples in the sample pool. */
+	int32 VideoSamplePool;
+
+	/** Number of video samples skipped in favor of newer ones (low-latency mode only). */
+	int32 SkippedVideoSamples;
+
+	/** Number of decoded video frames that were dropped to limit the delivery rate. */
+	int32 DecimatedVideoSamples;
+
+	/** Number of video samples that were skipped because they were identical to the previous one. */
+	int32 DuplicateVideoSamples;
+
+	/** Most recent value of LibVLC's demuxer byte counter, which is 32-bit and wraps around. */
+	int32 LibvlcDemuxBytesRead;
+
+	/** Most recent value of LibVLC's input byte counter, which is 32-bit and wraps around. */
+	int32 LibvlcInputBytesRead;
+
+public:
+
+	/** Default constructor. */
+	FVlcMediaPlayerStats()
+	{
+		Reset();
+	}
+
+public:
+
+	/**
+	 * Copy the media counters from the given LibVLC statistics.
+	 *
+	 * The byte counters are accumulated from the changes of LibVLC's counters,
+	 * so that they keep counting past 2 GB.
+	 *
+	 * @param Stats The statistics to copy.
+	 * @see RestartMedia
+	 */
+	void Assign(const FLibvlcMediaStats& Stats);
+
+	/**
+	 * Continue the byte counters with a new LibVLC media object, whose counters start at zero.
+	 *
+	 * @see Assign
+	 */
+	void RestartMedia();
+
+	/** Reset all counters to zero. */
+	void Reset();
+
+	/**
+	 * Publish the counters to the VlcMedia stat group and CSV profiler category.
+	 *
+	 * Counter stats are cleared every frame, so each player adds its values,
+	 * and the stat group shows the totals of all players.
+	 */
+	void Publish() const;
+};
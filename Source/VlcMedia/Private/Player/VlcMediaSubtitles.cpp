@@ -0,0 +1,424 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaSubtitles.h"
+#include "VlcMediaPrivate.h"
+
+#include "HAL/FileManager.h"
+#include "MediaSamples.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "VlcMediaOverlaySample.h"
+
+
+namespace VlcMediaSubtitles
+{
+	/** Extensions of subtitle files that VLC reads, but that aren't parsed here. */
+	const TCHAR* SlaveExtensions[] = { TEXT("aqt"), TEXT("ass"), TEXT("dks"), TEXT("idx"), TEXT("jss"), TEXT("mpl2"), TEXT("mpsub"), TEXT("pjs"), TEXT("psb"), TEXT("rt"), TEXT("sbv"), TEXT("smi"), TEXT("ssa"), TEXT("stl"), TEXT("sub"), TEXT("ttml"), TEXT("usf") };
+
+	/**
+	 * Check whether a file extension belongs to a subtitle format that is parsed here.
+	 *
+	 * @param Extension The extension to check (without dot).
+	 * @return true for SubRip and WebVTT, false otherwise.
+	 */
+	bool IsParsedExtension(const FString& Extension)
+	{
+		return Extension.Equals(TEXT("srt"), ESearchCase::IgnoreCase) || Extension.Equals(TEXT("vtt"), ESearchCase::IgnoreCase);
+	}
+
+	/**
+	 * Check whether a file extension belongs to a subtitle format that is left to VLC.
+	 *
+	 * @param Extension The extension to check (without dot).
+	 * @return true if VLC reads the format, false otherwise.
+	 */
+	bool IsSlaveExtension(const FString& Extension)
+	{
+		for (const TCHAR* SlaveExtension : SlaveExtensions)
+		{
+			if (Extension.Equals(SlaveExtension, ESearchCase::IgnoreCase))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Check whether a file name part is a language tag, i.e. en, eng, pt-BR or zh_Hant.
+	 *
+	 * @param String The string to check.
+	 * @return true if the string is a language tag, false otherwise.
+	 */
+	bool IsLanguageTag(const FString& String)
+	{
+		TArray<FString> Subtags;
+		String.Replace(TEXT("_"), TEXT("-")).ParseIntoArray(Subtags, TEXT("-"), false);
+
+		if ((Subtags.Num() == 0) || (Subtags[0].Len() < 2) || (Subtags[0].Len() > 3))
+		{
+			return false;
+		}
+
+		for (int32 SubtagIndex = 0; SubtagIndex < Subtags.Num(); ++SubtagIndex)
+		{
+			const FString& Subtag = Subtags[SubtagIndex];
+
+			if (Subtag.IsEmpty() || (Subtag.Len() > 8))
+			{
+				return false;
+			}
+
+			for (const TCHAR Char : Subtag)
+			{
+				// the primary language subtag is letters only
+				if (!FChar::IsAlpha(Char) && ((SubtagIndex == 0) || !FChar::IsDigit(Char)))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Parse a cue time, i.e. 01:02:03,456 (SubRip) or 02:03.456 (WebVTT).
+	 *
+	 * @param String The string to parse.
+	 * @param OutTime Will contain the parsed time.
+	 * @return true on success, false otherwise.
+	 */
+	bool ParseTime(const FString& String, FTimespan& OutTime)
+	{
+		TArray<FString> Parts;
+		String.TrimStartAndEnd().Replace(TEXT(","), TEXT(".")).ParseIntoArray(Parts, TEXT(":"), false);
+
+		if ((Parts.Num() < 2) || (Parts.Num() > 3))
+		{
+			return false;
+		}
+
+		double Seconds = 0.0;
+
+		for (const FString& Part : Parts)
+		{
+			if (Part.IsEmpty() || !FCString::IsNumeric(*Part))
+			{
+				return false;
+			}
+
+			Seconds = Seconds * 60.0 + FCString::Atod(*Part);
+		}
+
+		OutTime = FTimespan::FromSeconds(Seconds);
+
+		return true;
+	}
+
+	/**
+	 * Remove markup, such as <i>, <c.yellow> or {\an8}, from a cue text line.
+	 *
+	 * @param Line The line to strip.
+	 * @return The plain text.
+	 */
+	FString StripMarkup(const FString& Line)
+	{
+		FString Result;
+		Result.Reserve(Line.Len());
+
+		TCHAR Closing = 0;
+
+		for (const TCHAR Char : Line)
+		{
+			if (Closing != 0)
+			{
+				if (Char == Closing)
+				{
+					Closing = 0;
+				}
+			}
+			else if (Char == TEXT('<'))
+			{
+				Closing = TEXT('>');
+			}
+			else if (Char == TEXT('{'))
+			{
+				Closing = TEXT('}');
+			}
+			else
+			{
+				Result.AppendChar(Char);
+			}
+		}
+
+		return Result.Replace(TEXT("&amp;"), TEXT("&")).Replace(TEXT("&lt;"), TEXT("<")).Replace(TEXT("&gt;"), TEXT(">"));
+	}
+}
+
+
+/* FVlcMediaSubtitles structors
+ *****************************************************************************/
+
+FVlcMediaSubtitles::FVlcMediaSubtitles()
+	: NextCue(0)
+	, PreviousTime(FTimespan::MinValue())
+	, SelectedTrack(INDEX_NONE)
+{ }
+
+
+/* FVlcMediaSubtitles interface
+ *****************************************************************************/
+
+FString FVlcMediaSubtitles::GetTrackLanguage(int32 TrackIndex) const
+{
+	return Tracks.IsValidIndex(TrackIndex) ? Tracks[TrackIndex].Language : FString();
+}
+
+
+FString FVlcMediaSubtitles::GetTrackName(int32 TrackIndex) const
+{
+	return Tracks.IsValidIndex(TrackIndex) ? Tracks[TrackIndex].Name : FString();
+}
+
+
+int32 FVlcMediaSubtitles::Load(const FString& MediaPath)
+{
+	Reset();
+
+	const FString Directory = FPaths::GetPath(MediaPath);
+	const FString BaseName = FPaths::GetBaseFilename(MediaPath);
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(Directory, BaseName + TEXT(".*")), true, false);
+	FileNames.Sort();
+
+	// VLC decodes and blends all subtitle files if any of them is in a format that isn't parsed here
+	bool HasSlaveFormats = false;
+
+	for (const FString& FileName : FileNames)
+	{
+		if (VlcMediaSubtitles::IsSlaveExtension(FPaths::GetExtension(FileName)))
+		{
+			HasSlaveFormats = true;
+			break;
+		}
+	}
+
+	if (HasSlaveFormats)
+	{
+		for (const FString& FileName : FileNames)
+		{
+			const FString Extension = FPaths::GetExtension(FileName);
+
+			// VLC finds the VobSub .sub file next to its .idx file
+			if (Extension.Equals(TEXT("sub"), ESearchCase::IgnoreCase) && FileNames.ContainsByPredicate([&](const FString& Other) { return Other.Equals(FPaths::GetBaseFilename(FileName) + TEXT(".idx"), ESearchCase::IgnoreCase); }))
+			{
+				continue;
+			}
+
+			if (VlcMediaSubtitles::IsParsedExtension(Extension) || VlcMediaSubtitles::IsSlaveExtension(Extension))
+			{
+				SlaveFiles.Add(FPaths::ConvertRelativePathToFull(FPaths::Combine(Directory, FileName)));
+			}
+		}
+
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Subtitles %p: Leaving %i subtitle files of %s to VLC"), this, SlaveFiles.Num(), *MediaPath);
+
+		return 0;
+	}
+
+	for (const FString& FileName : FileNames)
+	{
+		const FString Extension = FPaths::GetExtension(FileName);
+
+		if (!VlcMediaSubtitles::IsParsedExtension(Extension))
+		{
+			continue;
+		}
+
+		FString Contents;
+
+		if (!FFileHelper::LoadFileToString(Contents, *FPaths::Combine(Directory, FileName)))
+		{
+			continue;
+		}
+
+		FTrack Track;
+
+		if (!Parse(Contents, Track.Cues))
+		{
+			UE_LOG(LogVlcMedia, Verbose, TEXT("Subtitles %p: No cues found in %s"), this, *FileName);
+			continue;
+		}
+
+		// Movie.en.srt => en, Movie.en.forced.srt => en, Movie.srt => none
+		const int32 QualifiersLen = FileName.Len() - BaseName.Len() - Extension.Len() - 2;
+
+		TArray<FString> Parts;
+
+		if (QualifiersLen > 0)
+		{
+			FileName.Mid(BaseName.Len() + 1, QualifiersLen).ParseIntoArray(Parts, TEXT("."));
+		}
+
+		for (const FString& Part : Parts)
+		{
+			if (VlcMediaSubtitles::IsLanguageTag(Part))
+			{
+				Track.Language = Part;
+				break;
+			}
+		}
+
+		Track.Name = FileName;
+
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Subtitles %p: Loaded %i cues from %s"), this, Track.Cues.Num(), *FileName);
+
+		Tracks.Add(MoveTemp(Track));
+	}
+
+	return Tracks.Num();
+}
+
+
+void FVlcMediaSubtitles::Reset()
+{
+	NextCue = 0;
+	PreviousTime = FTimespan::MinValue();
+	SelectedTrack = INDEX_NONE;
+	SlaveFiles.Reset();
+	Tracks.Reset();
+}
+
+
+bool FVlcMediaSubtitles::SelectTrack(int32 TrackIndex)
+{
+	if ((TrackIndex != INDEX_NONE) && !Tracks.IsValidIndex(TrackIndex))
+	{
+		return false;
+	}
+
+	if (TrackIndex != SelectedTrack)
+	{
+		SelectedTrack = TrackIndex;
+		PreviousTime = FTimespan::MinValue(); // re-synchronize on next tick
+	}
+
+	return true;
+}
+
+
+void FVlcMediaSubtitles::Tick(FTimespan Time, FMediaSamples& Samples)
+{
+	if (!Tracks.IsValidIndex(SelectedTrack))
+	{
+		return;
+	}
+
+	const TArray<FVlcMediaSubtitleCue>& Cues = Tracks[SelectedTrack].Cues;
+
+	// find first relevant cue after seeking or switching tracks
+	if (Time < PreviousTime)
+	{
+		NextCue = 0;
+	}
+	else if (PreviousTime == FTimespan::MinValue())
+	{
+		int32 Min = 0;
+		int32 Max = Cues.Num();
+
+		while (Min < Max)
+		{
+			const int32 Mid = (Min + Max) / 2;
+
+			if (Cues[Mid].Start <= Time)
+			{
+				Min = Mid + 1;
+			}
+			else
+			{
+				Max = Mid;
+			}
+		}
+
+		// include cues that started earlier and are still visible
+		while ((Min > 0) && (Cues[Min - 1].End > Time))
+		{
+			--Min;
+		}
+
+		NextCue = Min;
+	}
+
+	PreviousTime = Time;
+
+	// add cues that became visible
+	while (Cues.IsValidIndex(NextCue) && (Cues[NextCue].Start <= Time))
+	{
+		const FVlcMediaSubtitleCue& Cue = Cues[NextCue++];
+
+		if (Cue.End > Time)
+		{
+			Samples.AddCaption(MakeShared<FVlcMediaOverlaySample, ESPMode::ThreadSafe>(Cue.Text, Cue.Start, Cue.End - Cue.Start));
+		}
+	}
+}
+
+
+/* FVlcMediaSubtitles static functions
+ *****************************************************************************/
+
+bool FVlcMediaSubtitles::Parse(const FString& Contents, TArray<FVlcMediaSubtitleCue>& OutCues)
+{
+	TArray<FString> Lines;
+	Contents.ParseIntoArrayLines(Lines, false);
+
+	int32 LineIndex = 0;
+
+	while (LineIndex < Lines.Num())
+	{
+		// find cue timing line, i.e. 00:00:01,000 --> 00:00:04,000
+		FString StartString, EndString;
+
+		if (!Lines[LineIndex++].Split(TEXT("-->"), &StartString, &EndString))
+		{
+			continue;
+		}
+
+		// WebVTT cue settings follow the end time
+		EndString.TrimStartInline();
+		EndString.Split(TEXT(" "), &EndString, nullptr);
+
+		FVlcMediaSubtitleCue Cue;
+
+		if (!VlcMediaSubtitles::ParseTime(StartString, Cue.Start) || !VlcMediaSubtitles::ParseTime(EndString, Cue.End) || (Cue.End <= Cue.Start))
+		{
+			continue;
+		}
+
+		// cue text ends at the next empty line
+		FString Text;
+
+		while ((LineIndex < Lines.Num()) && !Lines[LineIndex].TrimStartAndEnd().IsEmpty())
+		{
+			if (!Text.IsEmpty())
+			{
+				Text += TEXT("\n");
+			}
+
+			Text += VlcMediaSubtitles::StripMarkup(Lines[LineIndex++].TrimStartAndEnd());
+		}
+
+		Cue.Text = FText::FromString(Text);
+		OutCues.Add(Cue);
+	}
+
+	OutCues.StableSort([](const FVlcMediaSubtitleCue& A, const FVlcMediaSubtitleCue& B) {
+		return (A.Start < B.Start);
+	});
+
+	return (OutCues.Num() > 0);
+}
@@ -0,0 +1,171 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FMediaSamples;
+
+
+/**
+ * A subtitle cue.
+ */
+struct FVlcMediaSubtitleCue
+{
+	/** Time at which the cue disappears. */
+	FTimespan End;
+
+	/** Time at which the cue appears. */
+	FTimespan Start;
+
+	/** The cue's text (may contain line breaks). */
+	FText Text;
+};
+
+
+/**
+ * Delivers subtitles as caption overlay samples.
+ *
+ * VLC only offers subtitles rasterized into the video frames, which requires
+ * a full frame blend and a text renderer. Instead, subtitle files next to the
+ * media file (SubRip and WebVTT) are parsed here, and their cues are added to
+ * the output samples as text captions at the appropriate play times. Media
+ * with subtitle files in other formats leaves all of them to VLC.
+ */
+class FVlcMediaSubtitles
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaSubtitles();
+
+public:
+
+	/**
+	 * Get the number of subtitle tracks.
+	 *
+	 * @return Number of tracks.
+	 */
+	int32 GetNumTracks() const
+	{
+		return Tracks.Num();
+	}
+
+	/**
+	 * Get the subtitle files that are left to VLC.
+	 *
+	 * @return Full paths of the subtitle files.
+	 * @see Load
+	 */
+	const TArray<FString>& GetSlaveFiles() const
+	{
+		return SlaveFiles;
+	}
+
+	/**
+	 * Get the index of the selected subtitle track.
+	 *
+	 * @return Track index, or INDEX_NONE if no track is selected.
+	 */
+	int32 GetSelectedTrack() const
+	{
+		return SelectedTrack;
+	}
+
+	/**
+	 * Get the language of a subtitle track.
+	 *
+	 * @param TrackIndex The index of the track.
+	 * @return Language code, or empty string if unknown.
+	 */
+	FString GetTrackLanguage(int32 TrackIndex) const;
+
+	/**
+	 * Get the name of a subtitle track.
+	 *
+	 * @param TrackIndex The index of the track.
+	 * @return Track name (the subtitle file name).
+	 */
+	FString GetTrackName(int32 TrackIndex) const;
+
+	/**
+	 * Find and load the subtitle files for the specified media file.
+	 *
+	 * Subtitle files must have the same base name as the media file and may
+	 * have a language suffix, i.e. Movie.srt, Movie.en.srt, Movie.pt-BR.vtt or
+	 * Movie.de.forced.srt. Their extensions are not case sensitive.
+	 *
+	 * Only SubRip and WebVTT files are parsed. If the media also has subtitle
+	 * files in other formats (i.e. .ass, .ssa or .idx), none of its subtitle
+	 * files are loaded, and all of them are left to VLC instead.
+	 *
+	 * @param MediaPath Path to the media file.
+	 * @return Number of subtitle tracks found.
+	 * @see GetSlaveFiles, Reset
+	 */
+	int32 Load(const FString& MediaPath);
+
+	/**
+	 * Remove all subtitle tracks.
+	 *
+	 * @see Load
+	 */
+	void Reset();
+
+	/**
+	 * Select a subtitle track.
+	 *
+	 * @param TrackIndex The index of the track to select, or INDEX_NONE to disable subtitles.
+	 * @return true on success, false if the track doesn't exist.
+	 */
+	bool SelectTrack(int32 TrackIndex);
+
+	/**
+	 * Add the cues that became visible since the previous call to the output samples.
+	 *
+	 * @param Time The player's current play time.
+	 * @param Samples The sample queues to add the captions to.
+	 */
+	void Tick(FTimespan Time, FMediaSamples& Samples);
+
+public:
+
+	/**
+	 * Parse a SubRip (.srt) or WebVTT (.vtt) subtitle file.
+	 *
+	 * @param Contents The contents of the subtitle file.
+	 * @param OutCues Will contain the cues, ordered by start time.
+	 * @return true if any cues were found, false otherwise.
+	 */
+	static bool Parse(const FString& Contents, TArray<FVlcMediaSubtitleCue>& OutCues);
+
+private:
+
+	/** A subtitle track. */
+	struct FTrack
+	{
+		/** The track's cues, ordered by start time. */
+		TArray<FVlcMediaSubtitleCue> Cues;
+
+		/** Language code (may be empty). */
+		FString Language;
+
+		/** Track name. */
+		FString Name;
+	};
+
+	/** Index of the next cue to be shown. */
+	int32 NextCue;
+
+	/** Play time of the previous tick. */
+	FTimespan PreviousTime;
+
+	/** Index of the selected track. */
+	int32 SelectedTrack;
+
+	/** Subtitle files that are left to VLC. */
+	TArray<FString> SlaveFiles;
+
+	/** The subtitle tracks. */
+	TArray<FTrack> Tracks;
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreTypes.h"
+#include "HAL/PlatformTime.h"
 #include "IMediaTextureSample.h"
 #include "MediaObjectPool.h"
 #include "Math/IntPoint.h"
@@ -24,7 +25,11 @@ public:
 		: Buffer(nullptr)
 		, BufferSize(0)
 		, Dim(FIntPoint::ZeroValue)
+		, DecodeCycles(0)
 		, Duration(FTimespan::Zero())
+		, EnqueueCycles(0)
+		, Hash(0)
+		, LockCycles(0)
 		, OutputDim(FIntPoint::ZeroValue)
 		, SampleFormat(EMediaTextureSampleFormat::Undefined)
 		, Stride(0)
@@ -39,6 +44,50 @@ public:
 
 public:
 
+	/**
+	 * Get the time at which the decoder finished writing the sample.
+	 *
+	 * @return Time in cycles (see FPlatformTime::Cycles64).
+	 * @see GetEnqueueCycles, GetLockCycles
+	 */
+	uint64 GetDecodeCycles() const
+	{
+		return DecodeCycles;
+	}
+
+	/**
+	 * Get the time at which the sample was added to the output queue.
+	 *
+	 * @return Time in cycles (see FPlatformTime::Cycles64).
+	 * @see GetDecodeCycles, GetLockCycles
+	 */
+	uint64 GetEnqueueCycles() const
+	{
+		return EnqueueCycles;
+	}
+
+	/**
+	 * Get the hash of the sample's image.
+	 *
+	 * @return Hash value (zero if not calculated).
+	 * @see SetHash
+	 */
+	uint64 GetHash() const
+	{
+		return Hash;
+	}
+
+	/**
+	 * Get the time at which the decoder acquired the sample.
+	 *
+	 * @return Time in cycles (see FPlatformTime::Cycles64).
+	 * @see GetDecodeCycles, GetEnqueueCycles
+	 */
+	uint64 GetLockCycles() const
+	{
+		return LockCycles;
+	}
+
 	/**
 	 * Get a writable pointer to the sample buffer.
 	 *
@@ -86,7 +135,11 @@ public:
 		}
 
 		Dim = InDim;
+		DecodeCycles = 0;
 		Duration = InDuration;
+		EnqueueCycles = 0;
+		Hash = 0;
+		LockCycles = FPlatformTime::Cycles64();
 		OutputDim = InOutputDim;
 		SampleFormat = InSampleFormat;
 		Stride = InStride;
@@ -94,6 +147,47 @@ public:
 		return true;
 	}
 
+	/**
+	 * Set the time at which the decoder finished writing the sample.
+	 *
+	 * @param Cycles The time to set (in cycles).
+	 */
+	void SetDecodeCycles(uint64 Cycles)
+	{
+		DecodeCycles = Cycles;
+	}
+
+	/**
+	 * Set the duration for which the sample is valid.
+	 *
+	 * @param InDuration The duration to set.
+	 */
+	void SetDuration(FTimespan InDuration)
+	{
+		Duration = InDuration;
+	}
+
+	/**
+	 * Set the time at which the sample was added to the output queue.
+	 *
+	 * @param Cycles The time to set (in cycles).
+	 */
+	void SetEnqueueCycles(uint64 Cycles)
+	{
+		EnqueueCycles = Cycles;
+	}
+
+	/**
+	 * Set the hash of the sample's image.
+	 *
+	 * @param InHash The hash value to set.
+	 * @see GetHash
+	 */
+	void SetHash(uint64 InHash)
+	{
+		Hash = InHash;
+	}
+
 	/**
 	 * Set the time for which the sample was generated.
 	 *
@@ -185,9 +279,21 @@ private:
 	/** Width and height of the texture sample. */
 	FIntPoint Dim;
 
+	/** Time at which the decoder finished writing the sample (in cycles). */
+	uint64 DecodeCycles;
+
 	/** Duration for which the sample is valid. */
 	FTimespan Duration;
 
+	/** Time at which the sample was added to the output queue (in cycles). */
+	uint64 EnqueueCycles;
+
+	/** Hash of the sample's image (zero if not calculated). */
+	uint64 Hash;
+
+	/** Time at which the decoder acquired the sample (in cycles). */
+	uint64 LockCycles;
+
 	/** Width and height of the output. */
 	FIntPoint OutputDim;
 
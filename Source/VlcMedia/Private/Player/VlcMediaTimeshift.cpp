@@ -0,0 +1,218 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaTimeshift.h"
+#include "VlcMediaPrivate.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+
+#include "Vlc.h"
+
+
+namespace VlcMediaTimeshift
+{
+	/** Length of recorded segments (in seconds). */
+	const int32 SegmentSeconds = 2;
+
+	/** Time between playlist updates (in seconds). */
+	const double UpdateInterval = 1.0;
+
+	/** Name of the playlist file. */
+	const TCHAR* PlaylistName = TEXT("index.m3u8");
+}
+
+
+/* FVlcMediaTimeshift structors
+ *****************************************************************************/
+
+FVlcMediaTimeshift::FVlcMediaTimeshift()
+	: FirstSequence(-1)
+	, LastUpdateTime(0.0)
+	, NumSegments(0)
+	, Recorder(nullptr)
+	, Window(FTimespan::Zero())
+	, WindowStart(FTimespan::Zero())
+{ }
+
+
+FVlcMediaTimeshift::~FVlcMediaTimeshift()
+{
+	Stop();
+}
+
+
+/* FVlcMediaTimeshift interface
+ *****************************************************************************/
+
+FString FVlcMediaTimeshift::GetPlaylistUrl() const
+{
+	return FString(TEXT("file:///")) + FPaths::Combine(Directory, VlcMediaTimeshift::PlaylistName).Replace(TEXT("\\"), TEXT("/")).TrimChar(TEXT('/'));
+}
+
+
+bool FVlcMediaTimeshift::IsAtLiveEdge(FTimespan Time) const
+{
+	return (Time >= WindowStart + Window - FTimespan::FromSeconds(VlcMediaTimeshift::SegmentSeconds));
+}
+
+
+bool FVlcMediaTimeshift::Start(FLibvlcInstance* VlcInstance, const FString& Url, FTimespan InMaxWindow)
+{
+	Stop();
+
+	Directory = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VlcMedia"), TEXT("Timeshift"), FGuid::NewGuid().ToString()));
+
+	if (!IFileManager::Get().MakeDirectory(*Directory, true))
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to create time-shift directory %s"), *Directory);
+		return false;
+	}
+
+	FLibvlcMedia* Media = FVlc::MediaNewLocation(VlcInstance, TCHAR_TO_ANSI(*Url));
+
+	if (Media == nullptr)
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to open live stream for time-shifting: %s (%s)"), *Url, ANSI_TO_TCHAR(FVlc::Errmsg()));
+		return false;
+	}
+
+	// remux into a rolling window of segments, which livehttp deletes as they expire
+	const int32 MaxSegments = FMath::Max(2, FMath::CeilToInt(InMaxWindow.GetTotalSeconds() / VlcMediaTimeshift::SegmentSeconds));
+	const FString SegmentPath = FPaths::Combine(Directory, TEXT("segment-########.ts")).Replace(TEXT("\\"), TEXT("/"));
+	const FString PlaylistPath = FPaths::Combine(Directory, VlcMediaTimeshift::PlaylistName).Replace(TEXT("\\"), TEXT("/"));
+
+	const FString Sout = FString::Printf(
+		TEXT(":sout=#std{access=livehttp{seglen=%i,delsegs=true,numsegs=%i,index=\"%s\",index-url=\"%s\"},mux=ts{use-key-frames},dst=\"%s\"}"),
+		VlcMediaTimeshift::SegmentSeconds,
+		MaxSegments,
+		*PlaylistPath,
+		*SegmentPath,
+		*SegmentPath
+	);
+
+	FVlc::MediaAddOption(Media, TCHAR_TO_ANSI(*Sout));
+	FVlc::MediaAddOption(Media, ":sout-all");
+	FVlc::MediaAddOption(Media, ":sout-keep");
+
+	Recorder = FVlc::MediaPlayerNewFromMedia(Media);
+	FVlc::MediaRelease(Media);
+
+	if ((Recorder == nullptr) || (FVlc::MediaPlayerPlay(Recorder) == -1))
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to start time-shift recording of %s (%s)"), *Url, ANSI_TO_TCHAR(FVlc::Errmsg()));
+		Stop();
+
+		return false;
+	}
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Time-shifting %s into %s (%i segments)"), *Url, *Directory, MaxSegments);
+
+	return true;
+}
+
+
+void FVlcMediaTimeshift::Stop()
+{
+	if (Recorder != nullptr)
+	{
+		FVlc::MediaPlayerStop(Recorder);
+		FVlc::MediaPlayerRelease(Recorder);
+		Recorder = nullptr;
+	}
+
+	if (!Directory.IsEmpty())
+	{
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+		Directory.Reset();
+	}
+
+	FirstSequence = -1;
+	LastUpdateTime = 0.0;
+	NumSegments = 0;
+	SegmentDurations.Reset();
+	Window = FTimespan::Zero();
+	WindowStart = FTimespan::Zero();
+}
+
+
+void FVlcMediaTimeshift::Update()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	if ((Recorder == nullptr) || (Now - LastUpdateTime < VlcMediaTimeshift::UpdateInterval))
+	{
+		return;
+	}
+
+	LastUpdateTime = Now;
+
+	FString Playlist;
+
+	if (!FFileHelper::LoadFileToString(Playlist, *FPaths::Combine(Directory, VlcMediaTimeshift::PlaylistName)))
+	{
+		return; // nothing recorded yet
+	}
+
+	TArray<FString> Lines;
+	Playlist.ParseIntoArrayLines(Lines);
+
+	TArray<double> Durations;
+	int32 Sequence = 0;
+
+	for (const FString& Line : Lines)
+	{
+		if (Line.StartsWith(TEXT("#EXTINF:")))
+		{
+			Durations.Add(FCString::Atod(*Line + 8));
+		}
+		else if (Line.StartsWith(TEXT("#EXT-X-MEDIA-SEQUENCE:")))
+		{
+			Sequence = FCString::Atoi(*Line + 22);
+		}
+	}
+
+	// move the window start past the segments that expired since the last update
+	if ((FirstSequence >= 0) && (Sequence > FirstSequence))
+	{
+		const int32 NumExpired = Sequence - FirstSequence;
+		double ExpiredSeconds = 0.0;
+
+		for (int32 Index = 0; Index < NumExpired; ++Index)
+		{
+			ExpiredSeconds += SegmentDurations.IsValidIndex(Index) ? SegmentDurations[Index] : (double)VlcMediaTimeshift::SegmentSeconds;
+		}
+
+		WindowStart += FTimespan::FromSeconds(ExpiredSeconds);
+	}
+
+	double Seconds = 0.0;
+
+	for (double Duration : Durations)
+	{
+		Seconds += Duration;
+	}
+
+	FirstSequence = Sequence;
+	NumSegments = Durations.Num();
+	SegmentDurations = MoveTemp(Durations);
+	Window = FTimespan::FromSeconds(Seconds);
+}
+
+
+/* FVlcMediaTimeshift static functions
+ *****************************************************************************/
+
+bool FVlcMediaTimeshift::IsLiveUrl(const FString& Url)
+{
+	FString Scheme;
+
+	if (!Url.Split(TEXT("://"), &Scheme, nullptr))
+	{
+		return false;
+	}
+
+	return (Scheme == TEXT("rtmp")) || (Scheme == TEXT("rtp")) || (Scheme == TEXT("rtsp")) || (Scheme == TEXT("udp")) || Scheme.StartsWith(TEXT("mms"));
+}
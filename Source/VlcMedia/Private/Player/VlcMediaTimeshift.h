@@ -0,0 +1,150 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FLibvlcInstance;
+struct FLibvlcMediaPlayer;
+
+
+/**
+ * Records a live stream into a bounded ring of segments on disk.
+ *
+ * The live stream is remuxed without decoding by a separate VLC player that
+ * writes fixed length MPEG-TS segments and a rolling HLS playlist. Segments
+ * that fall out of the time-shift window are deleted. The playlist can then
+ * be played back like any other media, which allows pausing and seeking
+ * back within the window while the recording continues.
+ *
+ * Times passed to and returned from this class are measured from the start
+ * of the recording unless noted otherwise, so that they don't jump when old
+ * segments expire. The current window starts at GetWindowStart.
+ */
+class FVlcMediaTimeshift
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaTimeshift();
+
+	/** Destructor. */
+	~FVlcMediaTimeshift();
+
+public:
+
+	/**
+	 * Get the URL of the playlist to play back.
+	 *
+	 * @return Playlist URL.
+	 * @see IsReady
+	 */
+	FString GetPlaylistUrl() const;
+
+	/**
+	 * Get the length of the time-shift window that is currently recorded.
+	 *
+	 * @return Window length.
+	 * @see GetWindowStart
+	 */
+	FTimespan GetWindow() const
+	{
+		return Window;
+	}
+
+	/**
+	 * Get the time at which the current time-shift window starts.
+	 *
+	 * @return Total length of the segments that expired since the recording started.
+	 * @see GetWindow
+	 */
+	FTimespan GetWindowStart() const
+	{
+		return WindowStart;
+	}
+
+	/**
+	 * Check whether a playback time is close to the end of the recorded window.
+	 *
+	 * @param Time The playback time to check.
+	 * @return true if the time is within one segment of the live edge, false otherwise.
+	 */
+	bool IsAtLiveEdge(FTimespan Time) const;
+
+	/**
+	 * Check whether a recording is active.
+	 *
+	 * @return true if recording, false otherwise.
+	 */
+	bool IsActive() const
+	{
+		return (Recorder != nullptr);
+	}
+
+	/**
+	 * Check whether enough of the stream was recorded to start playback.
+	 *
+	 * @return true if the playlist has at least one segment, false otherwise.
+	 */
+	bool IsReady() const
+	{
+		return (NumSegments > 0);
+	}
+
+	/**
+	 * Start recording a live stream.
+	 *
+	 * @param VlcInstance The LibVLC instance to use.
+	 * @param Url The URL of the live stream.
+	 * @param InMaxWindow The maximum length of the time-shift window.
+	 * @return true on success, false otherwise.
+	 * @see Stop
+	 */
+	bool Start(FLibvlcInstance* VlcInstance, const FString& Url, FTimespan InMaxWindow);
+
+	/**
+	 * Stop recording and delete the recorded segments.
+	 *
+	 * @see Start
+	 */
+	void Stop();
+
+	/** Update the recorded window from the playlist. */
+	void Update();
+
+public:
+
+	/**
+	 * Check whether a URL can be time-shifted.
+	 *
+	 * @param Url The URL to check.
+	 * @return true if the URL refers to a live stream protocol, false otherwise.
+	 */
+	static bool IsLiveUrl(const FString& Url);
+
+private:
+
+	/** Directory that holds the playlist and segments. */
+	FString Directory;
+
+	/** Sequence number of the first segment in the playlist (or -1 if not known yet). */
+	int32 FirstSequence;
+
+	/** Time of the last playlist update (in seconds). */
+	double LastUpdateTime;
+
+	/** Number of segments in the playlist. */
+	int32 NumSegments;
+
+	/** The player that records the live stream. */
+	FLibvlcMediaPlayer* Recorder;
+
+	/** Durations of the segments in the playlist (in seconds). */
+	TArray<double> SegmentDurations;
+
+	/** The recorded window. */
+	FTimespan Window;
+
+	/** Start time of the recorded window. */
+	FTimespan WindowStart;
+};
@@ -4,6 +4,10 @@
 #include "Vlc.h"
 
 #include "MediaHelpers.h"
+#include "Misc/Paths.h"
+
+#include "VlcMediaSubtitles.h"
+#include "VlcMediaUtils.h"
 
 
 #define LOCTEXT_NAMESPACE "FVlcMediaTracks"
@@ -13,123 +17,202 @@
 *****************************************************************************/
 
 FVlcMediaTracks::FVlcMediaTracks()
-	: Player(nullptr)
+	: Media(nullptr)
+	, Player(nullptr)
+	, Subtitles(nullptr)
 { }
 
 
 /* FVlcMediaTracks interface
 *****************************************************************************/
 
-void FVlcMediaTracks::Initialize(FLibvlcMediaPlayer& InPlayer, FString& OutInfo)
+bool FVlcMediaTracks::AddTrack(ELibvlcTrackType Type, int32 Id)
 {
-	Shutdown();
+	if ((Player == nullptr) || (Id == -1))
+	{
+		return false;
+	}
 
-	UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks: %p: Initializing tracks"), this);
+	int32 NumAdded = 0;
 
-	Player = &InPlayer;
+	switch (Type)
+	{
+	case ELibvlcTrackType::Audio:
+		NumAdded = AddTracks(Type, FVlc::AudioGetTrackDescription(Player), Id);
+		break;
+
+	case ELibvlcTrackType::Text:
+		if (HasSubtitleFiles())
+		{
+			return false; // captions are provided by subtitle files
+		}
+
+		NumAdded = AddTracks(Type, FVlc::VideoGetSpuDescription(Player), Id);
+		break;
+
+	case ELibvlcTrackType::Video:
+		NumAdded = AddTracks(Type, FVlc::VideoGetTrackDescription(Player), Id);
+		break;
 
-	int32 Width = FVlc::VideoGetWidth(Player);
-	int32 Height = FVlc::VideoGetHeight(Player);
+	default:
+		return false;
+	}
+
+	if (NumAdded == 0)
+	{
+		return false;
+	}
+
+	UpdateFormats();
+
+	return true;
+}
+
+
+FString FVlcMediaTracks::GetInfo() const
+{
+	FString Info;
 	int32 StreamCount = 0;
 
-	// @todo gmp: fix audio specs
-	FVlc::AudioSetFormat(Player, "S16N", 44100, 2);
-	FVlc::VideoSetFormat(Player, "RV32", Width, Height, Width * 4);
+	for (const FTrack& Track : AudioTracks)
+	{
+		Info += FString::Printf(TEXT("Stream %i\n"), StreamCount++);
+		Info += TEXT("    Type: Audio\n");
+		Info += FString::Printf(TEXT("    Name: %s\n"), *Track.Name);
+		Info += FString::Printf(TEXT("    Codec: %s\n"), *Track.TypeName);
+		Info += FString::Printf(TEXT("    Channels: %i\n"), Track.NumChannels);
+		Info += FString::Printf(TEXT("    Sample Rate: %i Hz\n"), Track.SampleRate);
+		Info += FString::Printf(TEXT("    Bit Rate: %i\n"), Track.BitRate);
+		Info += TEXT("\n");
+	}
 
-	// initialize audio tracks
-	FLibvlcTrackDescription* AudioTrackDescr = FVlc::AudioGetTrackDescription(Player);
+	for (const FTrack& Track : CaptionTracks)
 	{
-		while (AudioTrackDescr != nullptr)
-		{
-			if (AudioTrackDescr->Id != -1)
-			{
-				FTrack Track;
-				{
-					Track.Id = AudioTrackDescr->Id;
-					Track.Name = ANSI_TO_TCHAR(AudioTrackDescr->Name);
-					Track.DisplayName = Track.Name.IsEmpty()
-						? FText::Format(LOCTEXT("AudioTrackFormat", "Audio Track {0}"), FText::AsNumber(AudioTracks.Num()))
-						: FText::FromString(Track.Name);
-				}
-
-				AudioTracks.Add(Track);
-
-				OutInfo += FString::Printf(TEXT("Stream %i\n"), StreamCount);
-				OutInfo += TEXT("    Type: Audio\n");
-				OutInfo += FString::Printf(TEXT("    Name: %s\n"), *Track.Name);
-				OutInfo += TEXT("\n");
-
-				++StreamCount;
-			}
+		Info += FString::Printf(TEXT("Stream %i\n"), StreamCount++);
+		Info += TEXT("    Type: Caption\n");
+		Info += FString::Printf(TEXT("    Name: %s\n"), *Track.Name);
+		Info += FString::Printf(TEXT("    Codec: %s\n"), *Track.TypeName);
+		Info += TEXT("\n");
+	}
+
+	for (const FTrack& Track : VideoTracks)
+	{
+		Info += FString::Printf(TEXT("Stream %i\n"), StreamCount++);
+		Info += TEXT("    Type: Video\n");
+		Info += FString::Printf(TEXT("    Name: %s\n"), *Track.Name);
+		Info += FString::Printf(TEXT("    Codec: %s\n"), *Track.TypeName);
+		Info += FString::Printf(TEXT("    Dimensions: %i x %i\n"), Track.Dim.X, Track.Dim.Y);
+		Info += FString::Printf(TEXT("    Frame Rate: %g\n"), Track.FrameRate);
+		Info += FString::Printf(TEXT("    Bit Rate: %i\n"), Track.BitRate);
+		Info += TEXT("\n");
+	}
+
+	return Info;
+}
+
+
+void FVlcMediaTracks::GetMediaInfo(FVlcMediaInfo& OutInfo) const
+{
+	OutInfo.AudioTracks.Reset();
+	OutInfo.CaptionTracks.Reset();
+	OutInfo.VideoTracks.Reset();
+
+	for (const FTrack& Track : AudioTracks)
+	{
+		OutInfo.AudioTracks.Add(Track);
+	}
 
-			AudioTrackDescr = AudioTrackDescr->Next;
+	// subtitle files are not part of the media
+	if (!HasSubtitleFiles())
+	{
+		for (const FTrack& Track : CaptionTracks)
+		{
+			OutInfo.CaptionTracks.Add(Track);
 		}
 	}
-	FVlc::TrackDescriptionListRelease(AudioTrackDescr);
 
-	// initialize caption tracks
-	FLibvlcTrackDescription* CaptionTrackDescr = FVlc::VideoGetSpuDescription(Player);
+	for (const FTrack& Track : VideoTracks)
+	{
+		OutInfo.VideoTracks.Add(Track);
+	}
+}
+
+
+void FVlcMediaTracks::Initialize(FLibvlcMediaPlayer& InPlayer, FLibvlcMedia* InMedia, FVlcMediaSubtitles& InSubtitles, const FVlcMediaInfo* ProbedInfo)
+{
+	Shutdown();
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks: %p: Initializing tracks"), this);
+
+	Media = InMedia;
+	Player = &InPlayer;
+	Subtitles = &InSubtitles;
+
+	// note: output formats are negotiated in the format callbacks, which are
+	// installed for the lifetime of the player. FVlc::AudioSetFormat and
+	// FVlc::VideoSetFormat must not be used here, because they remove them.
+
+	// initialize audio & video tracks
+	if (ProbedInfo != nullptr)
 	{
-		while (CaptionTrackDescr != nullptr)
+		for (const FVlcMediaTrackInfo& Info : ProbedInfo->AudioTracks)
 		{
-			if (CaptionTrackDescr->Id != -1)
-			{
-				FTrack Track;
-				{
-					Track.Id = CaptionTrackDescr->Id;
-					Track.Name = ANSI_TO_TCHAR(CaptionTrackDescr->Name);
-					Track.DisplayName = Track.Name.IsEmpty()
-						? FText::Format(LOCTEXT("CaptionTrackFormat", "Caption Track {0}"), FText::AsNumber(CaptionTracks.Num()))
-						: FText::FromString(Track.Name);
-				}
-
-				CaptionTracks.Add(Track);
-				
-				OutInfo += FString::Printf(TEXT("Stream %i\n"), StreamCount);
-				OutInfo += TEXT("    Type: Caption\n");
-				OutInfo += FString::Printf(TEXT("    Name: %s\n"), *Track.Name);
-				OutInfo += TEXT("\n");
-
-				++StreamCount;
-			}
+			FTrack Track;
+			static_cast<FVlcMediaTrackInfo&>(Track) = Info;
+			Track.DisplayName = Info.Name.IsEmpty() ? FText::Format(LOCTEXT("AudioTrackFormat", "Audio Track {0}"), FText::AsNumber(AudioTracks.Num())) : FText::FromString(Info.Name);
+			AudioTracks.Add(Track);
+		}
 
-			CaptionTrackDescr = CaptionTrackDescr->Next;
+		for (const FVlcMediaTrackInfo& Info : ProbedInfo->VideoTracks)
+		{
+			FTrack Track;
+			static_cast<FVlcMediaTrackInfo&>(Track) = Info;
+			Track.DisplayName = Info.Name.IsEmpty() ? FText::Format(LOCTEXT("VideoTrackFormat", "Video Track {0}"), FText::AsNumber(VideoTracks.Num())) : FText::FromString(Info.Name);
+			VideoTracks.Add(Track);
 		}
 	}
-	FVlc::TrackDescriptionListRelease(CaptionTrackDescr);
+	else
+	{
+		AddTracks(ELibvlcTrackType::Audio, FVlc::AudioGetTrackDescription(Player), INDEX_NONE);
+		AddTracks(ELibvlcTrackType::Video, FVlc::VideoGetTrackDescription(Player), INDEX_NONE);
+	}
 
-	// initialize video tracks
-	FLibvlcTrackDescription* VideoTrackDescr = FVlc::VideoGetTrackDescription(Player);
+	// initialize caption tracks (VLC's sub-picture decoder is disabled for media with subtitle files)
+	if (!HasSubtitleFiles())
 	{
-		while (VideoTrackDescr != nullptr)
-		{
-			if (VideoTrackDescr->Id != -1)
-			{
-				FTrack Track;
-				{
-					Track.Id = VideoTrackDescr->Id;
-					Track.Name = ANSI_TO_TCHAR(VideoTrackDescr->Name);
-					Track.DisplayName = Track.Name.IsEmpty()
-						? FText::Format(LOCTEXT("VideoTrackFormat", "Video Track {0}"), FText::AsNumber(VideoTracks.Num()))
-						: FText::FromString(Track.Name);
-				}
-
-				VideoTracks.Add(Track);
-
-				OutInfo += FString::Printf(TEXT("Stream %i\n"), StreamCount);
-				OutInfo += TEXT("    Type: Video\n");
-				OutInfo += FString::Printf(TEXT("    Name: %s\n"), *Track.Name);
-				OutInfo += TEXT("\n");
-
-				++StreamCount;
-			}
+		AddTracks(ELibvlcTrackType::Text, FVlc::VideoGetSpuDescription(Player), INDEX_NONE);
+	}
 
-			VideoTrackDescr = VideoTrackDescr->Next;
+	for (int32 SubtitleIndex = 0; SubtitleIndex < Subtitles->GetNumTracks(); ++SubtitleIndex)
+	{
+		FTrack Track;
+		{
+			Track.Id = SubtitleIndex;
+			Track.Language = Subtitles->GetTrackLanguage(SubtitleIndex);
+			Track.Name = Subtitles->GetTrackName(SubtitleIndex);
+			Track.DisplayName = FText::FromString(Track.Name);
+			Track.TypeName = FPaths::GetExtension(Track.Name).ToUpper();
 		}
+
+		CaptionTracks.Add(Track);
 	}
-	FVlc::TrackDescriptionListRelease(VideoTrackDescr);
 
-	UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Found %i streams"), this, StreamCount);
+	UpdateFormats();
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Found %i streams"), this, AudioTracks.Num() + CaptionTracks.Num() + VideoTracks.Num());
+}
+
+
+bool FVlcMediaTracks::RemoveTrack(ELibvlcTrackType Type, int32 Id)
+{
+	TArray<FTrack>* Tracks = GetTracksForType(Type);
+
+	if ((Player == nullptr) || (Tracks == nullptr))
+	{
+		return false;
+	}
+
+	return (Tracks->RemoveAll([=](const FTrack& Track) { return (Track.Id == Id); }) > 0);
 }
 
 
@@ -140,8 +223,135 @@ void FVlcMediaTracks::Shutdown()
 	if (Player != nullptr)
 	{
 		AudioTracks.Reset();
+		CaptionTracks.Reset();
 		VideoTracks.Reset();
+		Media = nullptr;
 		Player = nullptr;
+		Subtitles = nullptr;
+	}
+}
+
+
+void FVlcMediaTracks::UpdateFormats()
+{
+	if (Media == nullptr)
+	{
+		return;
+	}
+
+	FVlcMediaInfo Info;
+	VlcMedia::ReadMediaInfo(Media, Info);
+
+	CopyFormats(Info.AudioTracks, AudioTracks);
+	CopyFormats(Info.VideoTracks, VideoTracks);
+
+	if (!HasSubtitleFiles())
+	{
+		CopyFormats(Info.CaptionTracks, CaptionTracks);
+	}
+}
+
+
+/* FVlcMediaTracks implementation
+*****************************************************************************/
+
+int32 FVlcMediaTracks::AddTracks(ELibvlcTrackType Type, FLibvlcTrackDescription* Descriptions, int32 OnlyId)
+{
+	TArray<FTrack>* Tracks = GetTracksForType(Type);
+	int32 NumAdded = 0;
+
+	for (FLibvlcTrackDescription* Descr = Descriptions; (Descr != nullptr) && (Tracks != nullptr); Descr = Descr->Next)
+	{
+		if ((Descr->Id == -1) || ((OnlyId != INDEX_NONE) && (Descr->Id != OnlyId)))
+		{
+			continue;
+		}
+
+		if (Tracks->ContainsByPredicate([=](const FTrack& Track) { return (Track.Id == Descr->Id); }))
+		{
+			continue; // already added
+		}
+
+		FTrack Track;
+		{
+			Track.Id = Descr->Id;
+			Track.Name = ANSI_TO_TCHAR(Descr->Name);
+
+			if (!Track.Name.IsEmpty())
+			{
+				Track.DisplayName = FText::FromString(Track.Name);
+			}
+			else if (Type == ELibvlcTrackType::Audio)
+			{
+				Track.DisplayName = FText::Format(LOCTEXT("AudioTrackFormat", "Audio Track {0}"), FText::AsNumber(Tracks->Num()));
+			}
+			else if (Type == ELibvlcTrackType::Text)
+			{
+				Track.DisplayName = FText::Format(LOCTEXT("CaptionTrackFormat", "Caption Track {0}"), FText::AsNumber(Tracks->Num()));
+			}
+			else
+			{
+				Track.DisplayName = FText::Format(LOCTEXT("VideoTrackFormat", "Video Track {0}"), FText::AsNumber(Tracks->Num()));
+			}
+		}
+
+		Tracks->Add(Track);
+		++NumAdded;
+	}
+
+	if (Descriptions != nullptr)
+	{
+		FVlc::TrackDescriptionListRelease(Descriptions);
+	}
+
+	return NumAdded;
+}
+
+
+TArray<FVlcMediaTracks::FTrack>* FVlcMediaTracks::GetTracksForType(ELibvlcTrackType Type)
+{
+	switch (Type)
+	{
+	case ELibvlcTrackType::Audio:
+		return &AudioTracks;
+
+	case ELibvlcTrackType::Text:
+		return HasSubtitleFiles() ? nullptr : &CaptionTracks;
+
+	case ELibvlcTrackType::Video:
+		return &VideoTracks;
+
+	default:
+		return nullptr;
+	}
+}
+
+
+bool FVlcMediaTracks::HasSubtitleFiles() const
+{
+	return ((Subtitles != nullptr) && (Subtitles->GetNumTracks() > 0));
+}
+
+
+/* FVlcMediaTracks static functions
+*****************************************************************************/
+
+void FVlcMediaTracks::CopyFormats(const TArray<FVlcMediaTrackInfo>& Infos, TArray<FTrack>& Tracks)
+{
+	for (const FVlcMediaTrackInfo& Info : Infos)
+	{
+		FTrack* Track = Tracks.FindByPredicate([&](const FTrack& Candidate) { return (Candidate.Id == Info.Id); });
+
+		if (Track != nullptr)
+		{
+			Track->BitRate = Info.BitRate;
+			Track->Dim = Info.Dim;
+			Track->FrameRate = Info.FrameRate;
+			Track->Language = Info.Language;
+			Track->NumChannels = Info.NumChannels;
+			Track->SampleRate = Info.SampleRate;
+			Track->TypeName = Info.TypeName;
+		}
 	}
 }
 
@@ -156,11 +366,12 @@ bool FVlcMediaTracks::GetAudioTrackFormat(int32 TrackIndex, int32 FormatIndex, F
 		return false;
 	}
 
-	// @todo gmp: fix audio format
-	OutFormat.BitsPerSample = 0;
-	OutFormat.NumChannels = 2;
-	OutFormat.SampleRate = 44100;
-	OutFormat.TypeName = TEXT("PCM");
+	const FTrack& Track = AudioTracks[TrackIndex];
+
+	OutFormat.BitsPerSample = 0; // not known for compressed streams
+	OutFormat.NumChannels = Track.NumChannels;
+	OutFormat.SampleRate = Track.SampleRate;
+	OutFormat.TypeName = Track.TypeName;
 
 	return true;
 }
@@ -209,6 +420,11 @@ int32 FVlcMediaTracks::GetSelectedTrack(EMediaTrackType TrackType) const
 		break;
 
 	case EMediaTrackType::Caption:
+		if (HasSubtitleFiles())
+		{
+			return Subtitles->GetSelectedTrack();
+		}
+
 		Tracks = &CaptionTracks;
 		TrackId = FVlc::VideoGetSpu(Player);
 		break;
@@ -276,7 +492,32 @@ int32 FVlcMediaTracks::GetTrackFormat(EMediaTrackType TrackType, int32 TrackInde
 
 FString FVlcMediaTracks::GetTrackLanguage(EMediaTrackType TrackType, int32 TrackIndex) const
 {
-	return TEXT("und"); // libvlc currently doesn't provide language codes
+	const FTrack* Track = nullptr;
+
+	switch (TrackType)
+	{
+	case EMediaTrackType::Audio:
+		Track = AudioTracks.IsValidIndex(TrackIndex) ? &AudioTracks[TrackIndex] : nullptr;
+		break;
+
+	case EMediaTrackType::Caption:
+		Track = CaptionTracks.IsValidIndex(TrackIndex) ? &CaptionTracks[TrackIndex] : nullptr;
+		break;
+
+	case EMediaTrackType::Video:
+		Track = VideoTracks.IsValidIndex(TrackIndex) ? &VideoTracks[TrackIndex] : nullptr;
+		break;
+
+	default:
+		break;
+	}
+
+	if ((Track == nullptr) || Track->Language.IsEmpty())
+	{
+		return TEXT("und");
+	}
+
+	return Track->Language;
 }
 
 
@@ -319,11 +560,13 @@ bool FVlcMediaTracks::GetVideoTrackFormat(int32 TrackIndex, int32 FormatIndex, F
 		return false;
 	}
 
-	// @todo gmp: fix video specs
-	OutFormat.Dim = FIntPoint(FVlc::VideoGetWidth(Player), FVlc::VideoGetHeight(Player));
-	OutFormat.FrameRate = FVlc::MediaPlayerGetFps(Player);
+	const FTrack& Track = VideoTracks[TrackIndex];
+
+	// fall back to the video output if the stream didn't specify its format
+	OutFormat.Dim = (Track.Dim.GetMin() > 0) ? Track.Dim : FIntPoint(FVlc::VideoGetWidth(Player), FVlc::VideoGetHeight(Player));
+	OutFormat.FrameRate = (Track.FrameRate > 0.0f) ? Track.FrameRate : FVlc::MediaPlayerGetFps(Player);
 	OutFormat.FrameRates = TRange<float>(OutFormat.FrameRate);
-	OutFormat.TypeName = TEXT("Default");
+	OutFormat.TypeName = Track.TypeName;
 
 	return true;
 }
@@ -338,81 +581,66 @@ bool FVlcMediaTracks::SelectTrack(EMediaTrackType TrackType, int32 TrackIndex)
 
 	UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Selecting %s track %i"), this, *MediaUtils::TrackTypeToString(TrackType), TrackIndex);
 
-	int32 TrackId = INDEX_NONE;
+	const TArray<FTrack>* Tracks = nullptr;
 
 	switch (TrackType)
 	{
 	case EMediaTrackType::Audio:
-		if (AudioTracks.IsValidIndex(TrackIndex))
-		{
-			TrackId = AudioTracks[TrackIndex].Id;
-		}
-		else if (TrackIndex == INDEX_NONE)
-		{
-			TrackId = -1;
-		}
-		else
-		{
-			return false; // invalid track
-		}
-
-		if (FVlc::AudioSetTrack(Player, TrackId) != 0)
-		{
-			UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Failed to %s audio track %i (id %i)"), this, (TrackId == -1) ? TEXT("disable") : TEXT("enable"), TrackIndex, TrackId);
-			return false;
-		}
+		Tracks = &AudioTracks;
+		break;
 
 	case EMediaTrackType::Caption:
-		if (CaptionTracks.IsValidIndex(TrackIndex))
-		{
-			TrackId = CaptionTracks[TrackIndex].Id;
-		}
-		else if (TrackIndex == INDEX_NONE)
-		{
-			TrackId = -1;
-		}
-		else
-		{
-			return false; // invalid track
-		}
-
-		if (FVlc::VideoSetSpu(Player, TrackId) != 0)
-		{
-			UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Failed to %s caption track %i (id %i)"), this, (TrackId == -1) ? TEXT("disable") : TEXT("enable"), TrackIndex, TrackId);
-			return false;
-		}
+		Tracks = &CaptionTracks;
+		break;
 
 	case EMediaTrackType::Video:
-		if (VideoTracks.IsValidIndex(TrackIndex))
-		{
-			TrackId = VideoTracks[TrackIndex].Id;
-		}
-		else if (TrackIndex == INDEX_NONE)
-		{
-			TrackId = -1;
-		}
-		else
-		{
-			return false; // invalid track
-		}
-
-		if ((TrackId != -1) && (FVlc::VideoSetTrack(Player, -1) != 0))
-		{
-			UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Failed to disable video decoding"), this);
-			return false;
-		}
-
-		if (FVlc::VideoSetTrack(Player, TrackId) != 0)
-		{
-			UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Failed to %s video track %i (id %i)"), this, (TrackId == -1) ? TEXT("disable") : TEXT("enable"), TrackIndex, TrackId);
-			return false;
-		}
+		Tracks = &VideoTracks;
+		break;
 
 	default:
 		return false; // unsupported track type
 	}
 
-	return true;
+	int32 TrackId = INDEX_NONE;
+
+	if (Tracks->IsValidIndex(TrackIndex))
+	{
+		TrackId = (*Tracks)[TrackIndex].Id;
+	}
+	else if (TrackIndex != INDEX_NONE)
+	{
+		return false; // invalid track
+	}
+
+	// switching streams restarts the decoder, so avoid redundant switches
+	if (GetSelectedTrack(TrackType) == TrackIndex)
+	{
+		return true;
+	}
+
+	bool Succeeded = false;
+
+	switch (TrackType)
+	{
+	case EMediaTrackType::Audio:
+		Succeeded = (FVlc::AudioSetTrack(Player, TrackId) == 0);
+		break;
+
+	case EMediaTrackType::Caption:
+		Succeeded = HasSubtitleFiles() ? Subtitles->SelectTrack(TrackId) : (FVlc::VideoSetSpu(Player, TrackId) == 0);
+		break;
+
+	case EMediaTrackType::Video:
+		Succeeded = (FVlc::VideoSetTrack(Player, TrackId) == 0);
+		break;
+	}
+
+	if (!Succeeded)
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Tracks %p: Failed to %s %s track %i (id %i)"), this, (TrackId == -1) ? TEXT("disable") : TEXT("enable"), *MediaUtils::TrackTypeToString(TrackType), TrackIndex, TrackId);
+	}
+
+	return Succeeded;
 }
 
 
@@ -7,7 +7,10 @@
 #include "IMediaTracks.h"
 #include "Internationalization/Text.h"
 
-struct FLibvlcMediaPlayer;
+#include "VlcMediaInfo.h"
+#include "VlcTypes.h"
+
+class FVlcMediaSubtitles;
 
 
 /**
@@ -17,11 +20,11 @@ class FVlcMediaTracks
 	: public IMediaTracks
 {
 	struct FTrack
+		: public FVlcMediaTrackInfo
 	{
+		/** Human readable track name. */
 		FText DisplayName;
-		int32 Id;
-		FString Name;
-	}; 
+	};
 
 public:
 
@@ -30,13 +33,73 @@ public:
 
 public:
 
+	/**
+	 * Add the track for an elementary stream that VLC created.
+	 *
+	 * @param Type The type of the elementary stream.
+	 * @param Id The identifier of the elementary stream.
+	 * @return true if a track was added, false otherwise.
+	 * @see RemoveTrack
+	 */
+	bool AddTrack(ELibvlcTrackType Type, int32 Id);
+
+	/**
+	 * Get information about the available media tracks.
+	 *
+	 * @return Information string.
+	 */
+	FString GetInfo() const;
+
+	/**
+	 * Get the formats of the audio and video tracks.
+	 *
+	 * @param OutInfo Will contain the track formats.
+	 */
+	void GetMediaInfo(FVlcMediaInfo& OutInfo) const;
+
 	/**
 	 * Initialize this object for the specified VLC media player.
 	 *
+	 * Tracks for elementary streams that already exist are added here, while
+	 * streams that are created or deleted later should be added or removed
+	 * incrementally. Track formats are read from the parsed media's
+	 * elementary streams. If subtitle files were found for the media, they
+	 * provide the caption tracks instead of VLC's subtitle streams.
+	 *
+	 * If previously probed media information is provided, the audio and
+	 * video tracks are created from it, so that they are available before
+	 * VLC finished parsing the media.
+	 *
 	 * @param InPlayer The VLC media player.
-	 * @param OutInfo Will contain information about the available media tracks.
+	 * @param InMedia The media that is playing.
+	 * @param InSubtitles The media's subtitle tracks.
+	 * @param ProbedInfo Previously probed media information (optional).
+	 * @see AddTrack, RemoveTrack, Shutdown
+	 */
+	void Initialize(FLibvlcMediaPlayer& InPlayer, FLibvlcMedia* InMedia, FVlcMediaSubtitles& InSubtitles, const FVlcMediaInfo* ProbedInfo = nullptr);
+
+	/**
+	 * Whether the tracks have been initialized.
+	 *
+	 * @return true if initialized, false otherwise.
+	 */
+	bool IsInitialized() const
+	{
+		return (Player != nullptr);
+	}
+
+	/**
+	 * Remove the track of an elementary stream that VLC deleted.
+	 *
+	 * @param Type The type of the elementary stream.
+	 * @param Id The identifier of the elementary stream.
+	 * @return true if a track was removed, false otherwise.
+	 * @see AddTrack
 	 */
-	void Initialize(FLibvlcMediaPlayer& InPlayer, FString& OutInfo);
+	bool RemoveTrack(ELibvlcTrackType Type, int32 Id);
+
+	/** Re-read the track formats from the media, i.e. after it has been parsed again. */
+	void UpdateFormats();
 
 	/** Shut down this object. */
 	void Shutdown();
@@ -57,6 +120,41 @@ public:
 	virtual bool SelectTrack(EMediaTrackType TrackType, int32 TrackIndex) override;
 	virtual bool SetTrackFormat(EMediaTrackType TrackType, int32 TrackIndex, int32 FormatIndex) override;
 
+protected:
+
+	/**
+	 * Add tracks for the given elementary stream descriptions.
+	 *
+	 * @param Type The type of the elementary streams.
+	 * @param Descriptions The stream descriptions (will be released).
+	 * @param OnlyId Only add the stream with this identifier, or INDEX_NONE to add all.
+	 * @return Number of added tracks.
+	 */
+	int32 AddTracks(ELibvlcTrackType Type, FLibvlcTrackDescription* Descriptions, int32 OnlyId);
+
+	/**
+	 * Copy track formats into the tracks with matching identifiers.
+	 *
+	 * @param Infos The track formats to copy.
+	 * @param Tracks The tracks to update.
+	 */
+	static void CopyFormats(const TArray<FVlcMediaTrackInfo>& Infos, TArray<FTrack>& Tracks);
+
+	/**
+	 * Get the track descriptors for the given elementary stream type.
+	 *
+	 * @param Type The elementary stream type.
+	 * @return The track descriptors, or nullptr if the type is not supported.
+	 */
+	TArray<FTrack>* GetTracksForType(ELibvlcTrackType Type);
+
+	/**
+	 * Check whether the caption tracks are provided by subtitle files.
+	 *
+	 * @return true if subtitle files were found, false if VLC's subtitle streams are used.
+	 */
+	bool HasSubtitleFiles() const;
+
 private:
 
 	/** Audio track descriptors. */
@@ -65,9 +163,15 @@ private:
 	/** Caption track descriptors. */
 	TArray<FTrack> CaptionTracks;
 
+	/** The VLC media object. */
+	FLibvlcMedia* Media;
+
 	/** The VLC media player object. */
 	FLibvlcMediaPlayer* Player;
 
+	/** The subtitle tracks. */
+	FVlcMediaSubtitles* Subtitles;
+
 	/** Video track descriptors. */
 	TArray<FTrack> VideoTracks;
 };
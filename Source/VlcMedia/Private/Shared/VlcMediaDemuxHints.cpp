@@ -0,0 +1,239 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaDemuxHints.h"
+#include "VlcMediaPrivate.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+namespace VlcMediaDemuxHints
+{
+	/** Magic number identifying hint files. */
+	const uint32 Magic = 0x56444D48; // 'VDMH'
+
+	/** Version of the hint file format. */
+	const int32 Version = 2;
+
+	/** Number of times media is probed after all candidates failed, before they are tried again. */
+	const int32 ProbesBeforeRetry = 16;
+
+	/** Get the path of the hint file. */
+	FString GetHintsPath()
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VlcMedia"), TEXT("DemuxHints.bin"));
+	}
+
+	/** Get the default candidate demux modules for a file extension (comma separated, in probe order). */
+	const TCHAR* GetDefaultDemuxers(const FString& Extension)
+	{
+		static const TCHAR* Defaults[][2] =
+		{
+			{ TEXT("3gp"), TEXT("mp4,avformat") },
+			{ TEXT("aac"), TEXT("es,avformat") },
+			{ TEXT("asf"), TEXT("asf,avformat") },
+			{ TEXT("avi"), TEXT("avi,avformat") },
+			{ TEXT("flac"), TEXT("flac,avformat") },
+			{ TEXT("flv"), TEXT("avformat") },
+			{ TEXT("m2ts"), TEXT("ts,avformat") },
+			{ TEXT("m4a"), TEXT("mp4,avformat") },
+			{ TEXT("m4v"), TEXT("mp4,es,avformat") },
+			{ TEXT("mka"), TEXT("mkv,avformat") },
+			{ TEXT("mkv"), TEXT("mkv,avformat") },
+			{ TEXT("mov"), TEXT("mp4,avformat") },
+			{ TEXT("mp3"), TEXT("es,avformat") },
+			{ TEXT("mp4"), TEXT("mp4,avformat") },
+			{ TEXT("mpeg"), TEXT("ps,ts,es") },
+			{ TEXT("mpg"), TEXT("ps,ts,es") },
+			{ TEXT("mts"), TEXT("ts,avformat") },
+			{ TEXT("oga"), TEXT("ogg,avformat") },
+			{ TEXT("ogg"), TEXT("ogg,avformat") },
+			{ TEXT("ogv"), TEXT("ogg,avformat") },
+			{ TEXT("opus"), TEXT("ogg,avformat") },
+			{ TEXT("ts"), TEXT("ts,avformat") },
+			{ TEXT("vob"), TEXT("ps,avformat") },
+			{ TEXT("wav"), TEXT("wav,avformat") },
+			{ TEXT("webm"), TEXT("mkv,avformat") },
+			{ TEXT("wma"), TEXT("asf,avformat") },
+			{ TEXT("wmv"), TEXT("asf,avformat") },
+		};
+
+		for (const auto& Default : Defaults)
+		{
+			if (Extension == Default[0])
+			{
+				return Default[1];
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+
+/* FVlcMediaDemuxHints structors
+ *****************************************************************************/
+
+FVlcMediaDemuxHints::FVlcMediaDemuxHints()
+	: Dirty(false)
+{ }
+
+
+/* FVlcMediaDemuxHints interface
+ *****************************************************************************/
+
+FString FVlcMediaDemuxHints::GetHint(const FString& Extension)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FOrder* Order = FindOrAddOrder(Extension.ToLower());
+
+	if ((Order == nullptr) || (Order->Demuxers.Num() == 0))
+	{
+		return FString();
+	}
+
+	if (Order->Failures >= Order->Demuxers.Num())
+	{
+		// all candidates failed, so probe for a while, then give them another chance
+		if (++Order->Probes < VlcMediaDemuxHints::ProbesBeforeRetry)
+		{
+			Dirty = true;
+			return FString();
+		}
+
+		Order->Failures = 0;
+		Order->Probes = 0;
+		Dirty = true;
+	}
+
+	return Order->Demuxers[0];
+}
+
+
+void FVlcMediaDemuxHints::Load()
+{
+	const FString HintsPath = VlcMediaDemuxHints::GetHintsPath();
+	TArray<uint8> Buffer;
+
+	if (!FFileHelper::LoadFileToArray(Buffer, *HintsPath, FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Buffer);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+
+	Reader << Magic << Version;
+
+	if ((Magic != VlcMediaDemuxHints::Magic) || (Version != VlcMediaDemuxHints::Version))
+	{
+		UE_LOG(LogVlcMedia, Log, TEXT("Ignoring incompatible demux hints %s"), *HintsPath);
+		return;
+	}
+
+	TMap<FString, FOrder> LoadedOrders;
+	Reader << LoadedOrders;
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to read demux hints %s"), *HintsPath);
+		return;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	Orders = MoveTemp(LoadedOrders);
+	Dirty = false;
+}
+
+
+void FVlcMediaDemuxHints::ReportResult(const FString& Extension, const FString& Demux, bool Succeeded)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	FOrder* Order = FindOrAddOrder(Extension.ToLower());
+
+	if ((Order == nullptr) || (Order->Demuxers.Remove(Demux) == 0))
+	{
+		return;
+	}
+
+	if (Succeeded)
+	{
+		// promote the demuxer that worked
+		Order->Demuxers.Insert(Demux, 0);
+		Order->Failures = 0;
+		Order->Probes = 0;
+	}
+	else
+	{
+		// rotate to the next candidate
+		Order->Demuxers.Add(Demux);
+		++Order->Failures;
+
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Demuxer %s failed to open a .%s file (%i of %i candidates failed)"), *Demux, *Extension, Order->Failures, Order->Demuxers.Num());
+	}
+
+	Dirty = true;
+}
+
+
+void FVlcMediaDemuxHints::Save()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (!Dirty)
+	{
+		return;
+	}
+
+	TArray<uint8> Buffer;
+	FMemoryWriter Writer(Buffer);
+
+	uint32 Magic = VlcMediaDemuxHints::Magic;
+	int32 Version = VlcMediaDemuxHints::Version;
+
+	Writer << Magic << Version << Orders;
+
+	const FString HintsPath = VlcMediaDemuxHints::GetHintsPath();
+
+	if (!FFileHelper::SaveArrayToFile(Buffer, *HintsPath))
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to save demux hints %s"), *HintsPath);
+		return;
+	}
+
+	Dirty = false;
+}
+
+
+/* FVlcMediaDemuxHints implementation
+ *****************************************************************************/
+
+FVlcMediaDemuxHints::FOrder* FVlcMediaDemuxHints::FindOrAddOrder(const FString& Extension)
+{
+	FOrder* Order = Orders.Find(Extension);
+
+	if (Order != nullptr)
+	{
+		return Order;
+	}
+
+	const TCHAR* DefaultDemux = VlcMediaDemuxHints::GetDefaultDemuxers(Extension);
+
+	if (DefaultDemux == nullptr)
+	{
+		return nullptr;
+	}
+
+	Order = &Orders.Add(Extension);
+	FString(DefaultDemux).ParseIntoArray(Order->Demuxers, TEXT(","));
+
+	return Order;
+}
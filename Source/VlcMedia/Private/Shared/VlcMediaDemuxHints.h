@@ -0,0 +1,104 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+
+/**
+ * Persistent probe order of VLC demuxers per file extension.
+ *
+ * Media that is streamed from an archive reaches VLC without a file name,
+ * so VLC would have to probe its demuxers by reading the stream. Instead,
+ * players force the first demuxer in the probe order of the original URL's
+ * extension. Each extension has a list of candidate demuxers, which starts
+ * out with the well known ones for common extensions. A demuxer that opens
+ * the media moves to the front of the list. If a demuxer fails, the player
+ * lets VLC probe the media instead, and only if that opens the media does
+ * the demuxer move to the back, so that the next candidate is tried next
+ * time. Corrupt or unreadable media therefore doesn't change the order. If
+ * all candidates failed in a row, media of the extension is probed for a
+ * while before the candidates are tried again. The order is loaded from and
+ * saved to the project's Saved directory.
+ */
+class FVlcMediaDemuxHints
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaDemuxHints();
+
+public:
+
+	/**
+	 * Get the demuxer to try next for a file extension.
+	 *
+	 * @param Extension The file extension (without dot).
+	 * @return Name of the VLC demux module, or an empty string if the media should be probed.
+	 * @see ReportResult
+	 */
+	FString GetHint(const FString& Extension);
+
+	/** Load the probe order from disk. */
+	void Load();
+
+	/**
+	 * Report whether a demuxer hint opened the media.
+	 *
+	 * Failures should only be reported if the media could be opened otherwise.
+	 *
+	 * @param Extension The file extension (without dot).
+	 * @param Demux Name of the VLC demux module that was tried.
+	 * @param Succeeded Whether the media was opened.
+	 */
+	void ReportResult(const FString& Extension, const FString& Demux, bool Succeeded);
+
+	/** Save the probe order to disk. */
+	void Save();
+
+protected:
+
+	/** Probe order of the candidate demuxers for an extension. */
+	struct FOrder
+	{
+		/** Demux module names, in probe order. */
+		TArray<FString> Demuxers;
+
+		/** Number of candidates that failed since one last succeeded. */
+		int32 Failures;
+
+		/** Number of times the media was probed since all candidates failed. */
+		int32 Probes;
+
+		/** Default constructor. */
+		FOrder()
+			: Failures(0)
+			, Probes(0)
+		{ }
+
+		friend FArchive& operator<<(FArchive& Ar, FOrder& Order)
+		{
+			return Ar << Order.Demuxers << Order.Failures << Order.Probes;
+		}
+	};
+
+	/**
+	 * Get the probe order of an extension, initializing it with the default demuxers if needed.
+	 *
+	 * @param Extension The file extension in lower case.
+	 * @return Probe order, or nullptr if no demuxers are known for the extension.
+	 */
+	FOrder* FindOrAddOrder(const FString& Extension);
+
+private:
+
+	/** Synchronizes access to the probe orders. */
+	FCriticalSection CriticalSection;
+
+	/** Whether the probe orders changed since they were loaded. */
+	bool Dirty;
+
+	/** Probe orders by extension. */
+	TMap<FString, FOrder> Orders;
+};
@@ -0,0 +1,110 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaHistogram.h"
+
+#include "HAL/PlatformAtomics.h"
+
+
+namespace VlcMediaHistogram
+{
+	/** Get the bucket index for the given value. */
+	int32 ValueToBucket(uint64 Value)
+	{
+		if (Value < 1)
+		{
+			return 0;
+		}
+
+		const int32 Octave = (int32)FMath::FloorLog2_64(Value);
+		const uint64 Base = 1ull << Octave;
+		const int32 Fraction = (int32)(((Value - Base) * FVlcMediaHistogram::BucketsPerOctave) / Base);
+
+		return FMath::Min(Octave * FVlcMediaHistogram::BucketsPerOctave + Fraction, FVlcMediaHistogram::NumBuckets - 1);
+	}
+
+	/** Get the upper bound of the given bucket. */
+	int64 BucketToValue(int32 Bucket)
+	{
+		const int32 Octave = Bucket / FVlcMediaHistogram::BucketsPerOctave;
+		const int32 Fraction = Bucket % FVlcMediaHistogram::BucketsPerOctave;
+		const int64 Base = 1ll << Octave;
+
+		return Base + (Base * (Fraction + 1)) / FVlcMediaHistogram::BucketsPerOctave;
+	}
+}
+
+
+/* FVlcMediaHistogram interface
+ *****************************************************************************/
+
+void FVlcMediaHistogram::Add(uint64 Microseconds)
+{
+	FPlatformAtomics::InterlockedIncrement(&Buckets[VlcMediaHistogram::ValueToBucket(Microseconds)]);
+	FPlatformAtomics::InterlockedIncrement(&Count);
+	FPlatformAtomics::InterlockedAdd(&Sum, (int64)Microseconds);
+
+	int64 OldMax = Max;
+
+	while ((int64)Microseconds > OldMax)
+	{
+		const int64 PrevMax = FPlatformAtomics::InterlockedCompareExchange(&Max, (int64)Microseconds, OldMax);
+
+		if (PrevMax == OldMax)
+		{
+			break;
+		}
+
+		OldMax = PrevMax;
+	}
+}
+
+
+int64 FVlcMediaHistogram::GetPercentile(float Percentile) const
+{
+	const int64 NumSamples = Count;
+
+	if (NumSamples <= 0)
+	{
+		return 0;
+	}
+
+	const int64 Threshold = FMath::Max<int64>(1, (int64)FMath::CeilToDouble(NumSamples * FMath::Clamp(Percentile, 0.0f, 1.0f)));
+	int64 Accumulated = 0;
+
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Accumulated += Buckets[Bucket];
+
+		if (Accumulated >= Threshold)
+		{
+			return FMath::Min<int64>(VlcMediaHistogram::BucketToValue(Bucket), Max);
+		}
+	}
+
+	return Max;
+}
+
+
+void FVlcMediaHistogram::Reset()
+{
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Buckets[Bucket] = 0;
+	}
+
+	Count = 0;
+	Max = 0;
+	Sum = 0;
+}
+
+
+FString FVlcMediaHistogram::ToCsv() const
+{
+	return FString::Printf(TEXT("%lld,%.1f,%lld,%lld,%lld"), (int64)Count, GetMean(), GetPercentile(0.5f), GetPercentile(0.99f), (int64)Max);
+}
+
+
+FString FVlcMediaHistogram::ToString() const
+{
+	return FString::Printf(TEXT("n=%lld mean=%.1fus p50=%lldus p99=%lldus max=%lldus"), (int64)Count, GetMean(), GetPercentile(0.5f), GetPercentile(0.99f), (int64)Max);
+}
@@ -0,0 +1,170 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+
+/**
+ * Implements a lock-free latency histogram.
+ *
+ * Values are recorded in microseconds into logarithmic buckets with four
+ * buckets per power of two, which bounds the percentile error to ~19%.
+ * Samples may be added from any thread, while readers get an approximate,
+ * but consistent enough, snapshot of the distribution.
+ */
+class FVlcMediaHistogram
+{
+public:
+
+	/** Number of buckets per power of two. */
+	static const int32 BucketsPerOctave = 4;
+
+	/** Total number of buckets (covers 1 us to ~68 s). */
+	static const int32 NumBuckets = 26 * BucketsPerOctave;
+
+public:
+
+	/** Default constructor. */
+	FVlcMediaHistogram()
+	{
+		Reset();
+	}
+
+public:
+
+	/**
+	 * Add a sample.
+	 *
+	 * @param Microseconds The sample value (in microseconds).
+	 * @see AddCycles
+	 */
+	void Add(uint64 Microseconds);
+
+	/**
+	 * Add a sample that was measured in CPU cycles.
+	 *
+	 * @param Cycles The sample value (in cycles, see FPlatformTime::Cycles64).
+	 * @see Add
+	 */
+	void AddCycles(uint64 Cycles)
+	{
+		Add((uint64)(FPlatformTime::ToSeconds64(Cycles) * 1000000.0));
+	}
+
+	/**
+	 * Get the number of recorded samples.
+	 *
+	 * @return Sample count.
+	 */
+	int64 GetCount() const
+	{
+		return Count;
+	}
+
+	/**
+	 * Get the largest recorded sample.
+	 *
+	 * @return Maximum value (in microseconds).
+	 */
+	int64 GetMax() const
+	{
+		return Max;
+	}
+
+	/**
+	 * Get the average of all recorded samples.
+	 *
+	 * @return Mean value (in microseconds).
+	 */
+	double GetMean() const
+	{
+		return (Count > 0) ? (double)Sum / (double)Count : 0.0;
+	}
+
+	/**
+	 * Get an estimate of the specified percentile.
+	 *
+	 * @param Percentile The percentile to get (0.0 to 1.0).
+	 * @return The percentile value (in microseconds).
+	 */
+	int64 GetPercentile(float Percentile) const;
+
+	/** Remove all samples. */
+	void Reset();
+
+	/**
+	 * Get a one-line summary of the histogram.
+	 *
+	 * @return Summary string.
+	 */
+	FString ToString() const;
+
+public:
+
+	/**
+	 * Get the column names matching ToCsv.
+	 *
+	 * @return Comma separated column names.
+	 */
+	static const TCHAR* GetCsvHeader()
+	{
+		return TEXT("Count,Mean (us),P50 (us),P99 (us),Max (us)");
+	}
+
+	/**
+	 * Get the histogram's summary as comma separated values.
+	 *
+	 * @return Comma separated values.
+	 * @see GetCsvHeader
+	 */
+	FString ToCsv() const;
+
+private:
+
+	/** The sample buckets. */
+	volatile int64 Buckets[NumBuckets];
+
+	/** Number of samples. */
+	volatile int64 Count;
+
+	/** Largest sample value. */
+	volatile int64 Max;
+
+	/** Sum of all sample values. */
+	volatile int64 Sum;
+};
+
+
+/**
+ * Adds the time spent in a scope to a histogram.
+ */
+class FVlcMediaScopedTimer
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InHistogram The histogram to add the measured time to.
+	 */
+	explicit FVlcMediaScopedTimer(FVlcMediaHistogram& InHistogram)
+		: Histogram(InHistogram)
+		, StartCycles(FPlatformTime::Cycles64())
+	{ }
+
+	/** Destructor. */
+	~FVlcMediaScopedTimer()
+	{
+		Histogram.AddCycles(FPlatformTime::Cycles64() - StartCycles);
+	}
+
+private:
+
+	/** The histogram to add to. */
+	FVlcMediaHistogram& Histogram;
+
+	/** Time at which the scope was entered. */
+	uint64 StartCycles;
+};
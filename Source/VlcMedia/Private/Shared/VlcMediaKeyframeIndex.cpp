@@ -0,0 +1,604 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaKeyframeIndex.h"
+#include "VlcMediaPrivate.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Templates/UniquePtr.h"
+
+
+namespace VlcMediaKeyframeIndex
+{
+	/** Magic number identifying index files. */
+	const uint32 Magic = 0x564b4649; // 'VKFI'
+
+	/** Version of the index file format. */
+	const int32 Version = 2;
+
+	/** Size of MPEG transport stream packets. */
+	const int32 TsPacketSize = 188;
+
+	/** Number of packets to read at once. */
+	const int32 PacketsPerRead = 4096;
+
+	/** Resolution of MPEG system clock timestamps (in Hz). */
+	const int64 TimestampRate = 90000;
+
+	/** Get the path of the index file for the specified media file. */
+	FString GetIndexPath(const FString& FilePath)
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VlcMedia"), TEXT("Keyframes"), FMD5::HashAnsiString(*FilePath) + TEXT(".bin"));
+	}
+
+	/** Check whether a transport stream type is a supported video codec. */
+	bool IsVideoStreamType(uint8 StreamType)
+	{
+		return (StreamType == 0x01) || (StreamType == 0x02) || (StreamType == 0x1b) || (StreamType == 0x24);
+	}
+
+	/**
+	 * Check whether a video elementary stream fragment contains the start of a key frame.
+	 *
+	 * @param StreamType The transport stream type of the video stream.
+	 * @param Data The fragment data.
+	 * @param Size The size of the fragment.
+	 * @return true if a key frame starts in the fragment, false otherwise.
+	 */
+	bool HasKeyframeStart(uint8 StreamType, const uint8* Data, int32 Size)
+	{
+		for (int32 Index = 0; Index + 3 < Size; ++Index)
+		{
+			if ((Data[Index] != 0x00) || (Data[Index + 1] != 0x00) || (Data[Index + 2] != 0x01))
+			{
+				continue;
+			}
+
+			const uint8 Code = Data[Index + 3];
+
+			switch (StreamType)
+			{
+			case 0x01:
+			case 0x02: // MPEG-2: sequence header or group of pictures
+				if ((Code == 0xb3) || (Code == 0xb8))
+				{
+					return true;
+				}
+				break;
+
+			case 0x1b: // H.264: sequence parameter set or IDR slice
+				if (((Code & 0x1f) == 7) || ((Code & 0x1f) == 5))
+				{
+					return true;
+				}
+				break;
+
+			case 0x24: // HEVC: video parameter set or intra random access point
+				{
+					const uint8 NalType = (Code >> 1) & 0x3f;
+
+					if ((NalType == 32) || ((NalType >= 16) && (NalType <= 21)))
+					{
+						return true;
+					}
+				}
+				break;
+			}
+		}
+
+		return false;
+	}
+
+	/**
+	 * Get the program map table section in a PAT or PMT packet payload.
+	 *
+	 * @param Payload The packet payload.
+	 * @param PayloadSize The size of the payload.
+	 * @param TableId The expected table identifier.
+	 * @param OutSectionSize Will contain the size of the section without CRC.
+	 * @return The section, or nullptr if the payload doesn't contain a complete section.
+	 */
+	const uint8* GetSection(const uint8* Payload, int32 PayloadSize, uint8 TableId, int32& OutSectionSize)
+	{
+		if (PayloadSize < 1)
+		{
+			return nullptr;
+		}
+
+		const int32 Start = 1 + Payload[0]; // pointer field
+
+		if (Start + 3 > PayloadSize)
+		{
+			return nullptr;
+		}
+
+		const uint8* Section = Payload + Start;
+		OutSectionSize = (((Section[1] & 0x0f) << 8) | Section[2]) + 3 - 4;
+
+		if ((Section[0] != TableId) || (OutSectionSize < 8) || (Start + OutSectionSize > PayloadSize))
+		{
+			return nullptr;
+		}
+
+		return Section;
+	}
+}
+
+
+/* FVlcMediaKeyframeIndex structors
+ *****************************************************************************/
+
+FVlcMediaKeyframeIndex::FVlcMediaKeyframeIndex()
+{ }
+
+
+FVlcMediaKeyframeIndex::~FVlcMediaKeyframeIndex()
+{
+	Reset();
+}
+
+
+/* FVlcMediaKeyframeIndex interface
+ *****************************************************************************/
+
+void FVlcMediaKeyframeIndex::Build(const FString& FilePath)
+{
+	Reset();
+
+	const FString FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+
+	Data = Load(FullPath);
+
+	if (Data.IsValid())
+	{
+		return;
+	}
+
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> TaskCanceled = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+
+	Canceled = TaskCanceled;
+	Future = Async<TSharedPtr<FData, ESPMode::ThreadSafe>>(EAsyncExecution::ThreadPool, [FullPath, TaskCanceled]() {
+		return BuildAndSave(FullPath, *TaskCanceled);
+	});
+}
+
+
+bool FVlcMediaKeyframeIndex::FindKeyframe(FTimespan Time, FVlcMediaKeyframe& OutKeyframe)
+{
+	if (!UpdateData())
+	{
+		return false;
+	}
+
+	const TArray<FVlcMediaKeyframe>& Keyframes = Data->Keyframes;
+
+	// find first key frame after the requested time
+	int32 Min = 0;
+	int32 Max = Keyframes.Num();
+
+	while (Min < Max)
+	{
+		const int32 Mid = (Min + Max) / 2;
+
+		if (Keyframes[Mid].Time <= Time)
+		{
+			Min = Mid + 1;
+		}
+		else
+		{
+			Max = Mid;
+		}
+	}
+
+	OutKeyframe = Keyframes[FMath::Max(0, Min - 1)];
+
+	return true;
+}
+
+
+FTimespan FVlcMediaKeyframeIndex::GetAverageInterval()
+{
+	if (!UpdateData() || (Data->Keyframes.Num() < 2))
+	{
+		return FTimespan::Zero();
+	}
+
+	return FTimespan((Data->Keyframes.Last().Time - Data->Keyframes[0].Time).GetTicks() / (Data->Keyframes.Num() - 1));
+}
+
+
+float FVlcMediaKeyframeIndex::GetPosition(const FVlcMediaKeyframe& Keyframe)
+{
+	if (!UpdateData() || (Data->FileSize <= 0))
+	{
+		return 0.0f;
+	}
+
+	// positions are floats, so back off to make sure VLC lands before the key frame
+	const int64 Slack = VlcMediaKeyframeIndex::TsPacketSize + (Data->FileSize >> 23);
+	const int64 Offset = FMath::Max<int64>(0, Keyframe.Offset - Slack);
+
+	return (float)((double)Offset / (double)Data->FileSize);
+}
+
+
+bool FVlcMediaKeyframeIndex::IsAvailable()
+{
+	return UpdateData();
+}
+
+
+void FVlcMediaKeyframeIndex::Reset()
+{
+	if (Canceled.IsValid())
+	{
+		*Canceled = true;
+		Canceled.Reset();
+	}
+
+	if (Future.IsValid())
+	{
+		Future.Wait();
+		Future = TFuture<TSharedPtr<FData, ESPMode::ThreadSafe>>();
+	}
+
+	Data.Reset();
+}
+
+
+/* FVlcMediaKeyframeIndex implementation
+ *****************************************************************************/
+
+bool FVlcMediaKeyframeIndex::UpdateData()
+{
+	if (!Data.IsValid() && Future.IsValid() && Future.IsReady())
+	{
+		Data = Future.Get();
+		Future = TFuture<TSharedPtr<FData, ESPMode::ThreadSafe>>();
+		Canceled.Reset();
+	}
+
+	return Data.IsValid() && (Data->Keyframes.Num() > 0);
+}
+
+
+/* FVlcMediaKeyframeIndex static functions
+ *****************************************************************************/
+
+bool FVlcMediaKeyframeIndex::IsSupported(const FString& FilePath)
+{
+	const FString Extension = FPaths::GetExtension(FilePath).ToLower();
+
+	return (Extension == TEXT("ts")) || (Extension == TEXT("m2t")) || (Extension == TEXT("m2ts")) || (Extension == TEXT("mts"));
+}
+
+
+TSharedPtr<FVlcMediaKeyframeIndex::FData, ESPMode::ThreadSafe> FVlcMediaKeyframeIndex::BuildAndSave(const FString& FilePath, const FThreadSafeBool& Canceled)
+{
+	auto Result = MakeShared<FData, ESPMode::ThreadSafe>();
+	{
+		Result->FileSize = IFileManager::Get().FileSize(*FilePath);
+		Result->Timestamp = IFileManager::Get().GetTimeStamp(*FilePath);
+	}
+
+	if (Result->FileSize <= 0)
+	{
+		return nullptr;
+	}
+
+	// build new index
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (!Scan(FilePath, Canceled, Result->Keyframes))
+	{
+		return nullptr;
+	}
+
+	UE_LOG(LogVlcMedia, Log, TEXT("Indexed %i key frames in %s (%.2f seconds)"), Result->Keyframes.Num(), *FilePath, FPlatformTime::Seconds() - StartTime);
+
+	// save index
+	TArray<uint8> Buffer;
+	FMemoryWriter Writer(Buffer);
+
+	uint32 Magic = VlcMediaKeyframeIndex::Magic;
+	int32 Version = VlcMediaKeyframeIndex::Version;
+
+	Writer << Magic << Version << Result->FileSize << Result->Timestamp << Result->Keyframes;
+
+	const FString IndexPath = VlcMediaKeyframeIndex::GetIndexPath(FilePath);
+
+	if (!FFileHelper::SaveArrayToFile(Buffer, *IndexPath))
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to save key frame index %s"), *IndexPath);
+	}
+
+	return Result;
+}
+
+
+TSharedPtr<FVlcMediaKeyframeIndex::FData, ESPMode::ThreadSafe> FVlcMediaKeyframeIndex::Load(const FString& FilePath)
+{
+	auto Result = MakeShared<FData, ESPMode::ThreadSafe>();
+	{
+		Result->FileSize = IFileManager::Get().FileSize(*FilePath);
+		Result->Timestamp = IFileManager::Get().GetTimeStamp(*FilePath);
+	}
+
+	if (Result->FileSize <= 0)
+	{
+		return nullptr;
+	}
+
+	TArray<uint8> Buffer;
+
+	if (!FFileHelper::LoadFileToArray(Buffer, *VlcMediaKeyframeIndex::GetIndexPath(FilePath), FILEREAD_Silent))
+	{
+		return nullptr;
+	}
+
+	FMemoryReader Reader(Buffer);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int64 FileSize = 0;
+	FDateTime Timestamp;
+
+	Reader << Magic << Version << FileSize << Timestamp;
+
+	if ((Magic != VlcMediaKeyframeIndex::Magic) || (Version != VlcMediaKeyframeIndex::Version) || (FileSize != Result->FileSize) || (Timestamp != Result->Timestamp))
+	{
+		return nullptr;
+	}
+
+	Reader << Result->Keyframes;
+
+	if (Reader.IsError() || (Result->Keyframes.Num() == 0))
+	{
+		return nullptr;
+	}
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Loaded %i key frames for %s"), Result->Keyframes.Num(), *FilePath);
+
+	return Result;
+}
+
+
+bool FVlcMediaKeyframeIndex::Scan(const FString& FilePath, const FThreadSafeBool& Canceled, TArray<FVlcMediaKeyframe>& OutKeyframes)
+{
+	using namespace VlcMediaKeyframeIndex;
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+
+	if (!Reader.IsValid())
+	{
+		return false;
+	}
+
+	const int64 FileSize = Reader->TotalSize();
+
+	// detect packet size: 188 (TS) or 192 (M2TS, with 4-byte time code prefix)
+	uint8 Probe[3 * 192];
+
+	if (FileSize < (int64)sizeof(Probe))
+	{
+		return false;
+	}
+
+	Reader->Serialize(Probe, sizeof(Probe));
+
+	int32 PacketSize = 0;
+	int32 SyncOffset = 0;
+
+	if ((Probe[0] == 0x47) && (Probe[188] == 0x47) && (Probe[376] == 0x47))
+	{
+		PacketSize = 188;
+	}
+	else if ((Probe[4] == 0x47) && (Probe[196] == 0x47) && (Probe[388] == 0x47))
+	{
+		PacketSize = 192;
+		SyncOffset = 4;
+	}
+	else
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("%s is not a transport stream"), *FilePath);
+		return false;
+	}
+
+	Reader->Seek(0);
+
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(PacketSize * PacketsPerRead);
+
+	int32 PcrPid = -1;
+	int32 PmtPid = -1;
+	int32 VideoPid = -1;
+	uint8 VideoStreamType = 0;
+	int64 FirstPcr = -1;
+	int64 FirstPts = -1;
+	int64 LastPts = -1;
+	int64 PtsWraps = 0;
+
+	// presentation times of the key frames, relative to the first video frame
+	TArray<int64> KeyframePts;
+
+	for (int64 BufferOffset = 0; BufferOffset + PacketSize <= FileSize; BufferOffset += Buffer.Num())
+	{
+		if (Canceled)
+		{
+			return false;
+		}
+
+		const int32 BufferSize = (int32)FMath::Min<int64>(Buffer.Num(), FileSize - BufferOffset);
+		Reader->Serialize(Buffer.GetData(), BufferSize);
+
+		if (Reader->IsError())
+		{
+			return false;
+		}
+
+		for (int32 PacketOffset = 0; PacketOffset + PacketSize <= BufferSize; PacketOffset += PacketSize)
+		{
+			const uint8* Packet = Buffer.GetData() + PacketOffset + SyncOffset;
+
+			if (Packet[0] != 0x47)
+			{
+				continue; // lost sync
+			}
+
+			const bool UnitStart = (Packet[1] & 0x40) != 0;
+			const int32 Pid = ((Packet[1] & 0x1f) << 8) | Packet[2];
+			const uint8 AdaptationControl = (Packet[3] >> 4) & 0x03;
+
+			// program clock reference: VLC reports playback times relative to the first one
+			if ((FirstPcr < 0) && (Pid == PcrPid) && (AdaptationControl & 0x02) && (Packet[4] >= 7) && ((Packet[5] & 0x10) != 0))
+			{
+				FirstPcr =
+					((int64)Packet[6] << 25) |
+					((int64)Packet[7] << 17) |
+					((int64)Packet[8] << 9) |
+					((int64)Packet[9] << 1) |
+					((int64)Packet[10] >> 7);
+			}
+
+			if (!UnitStart || ((AdaptationControl & 0x01) == 0))
+			{
+				continue; // only payload starts are of interest
+			}
+
+			int32 PayloadStart = 4;
+			bool RandomAccess = false;
+
+			if (AdaptationControl & 0x02)
+			{
+				const uint8 AdaptationLength = Packet[4];
+				RandomAccess = (AdaptationLength > 0) && ((Packet[5] & 0x40) != 0);
+				PayloadStart += 1 + AdaptationLength;
+			}
+
+			if (PayloadStart >= TsPacketSize)
+			{
+				continue;
+			}
+
+			const uint8* Payload = Packet + PayloadStart;
+			const int32 PayloadSize = TsPacketSize - PayloadStart;
+			int32 SectionSize = 0;
+
+			if (Pid == 0)
+			{
+				// program association table: use first program
+				const uint8* Section = GetSection(Payload, PayloadSize, 0x00, SectionSize);
+
+				for (int32 Index = 8; (Section != nullptr) && (Index + 4 <= SectionSize) && (PmtPid == -1); Index += 4)
+				{
+					if ((Section[Index] != 0) || (Section[Index + 1] != 0))
+					{
+						PmtPid = ((Section[Index + 2] & 0x1f) << 8) | Section[Index + 3];
+					}
+				}
+			}
+			else if ((Pid == PmtPid) && (VideoPid == -1))
+			{
+				// program map table: use first video stream
+				const uint8* Section = GetSection(Payload, PayloadSize, 0x02, SectionSize);
+
+				if (Section != nullptr)
+				{
+					PcrPid = ((Section[8] & 0x1f) << 8) | Section[9];
+
+					const int32 ProgramInfoLength = ((Section[10] & 0x0f) << 8) | Section[11];
+
+					for (int32 Index = 12 + ProgramInfoLength; Index + 5 <= SectionSize; Index += 5 + (((Section[Index + 3] & 0x0f) << 8) | Section[Index + 4]))
+					{
+						if (IsVideoStreamType(Section[Index]))
+						{
+							VideoPid = ((Section[Index + 1] & 0x1f) << 8) | Section[Index + 2];
+							VideoStreamType = Section[Index];
+
+							break;
+						}
+					}
+				}
+			}
+			else if ((Pid == VideoPid) && (PayloadSize >= 14) && (Payload[0] == 0x00) && (Payload[1] == 0x00) && (Payload[2] == 0x01))
+			{
+				// packetized elementary stream header with PTS
+				if ((Payload[7] & 0x80) == 0)
+				{
+					continue;
+				}
+
+				int64 Pts =
+					((int64)((Payload[9] >> 1) & 0x07) << 30) |
+					((int64)Payload[10] << 22) |
+					((int64)(Payload[11] >> 1) << 15) |
+					((int64)Payload[12] << 7) |
+					((int64)Payload[13] >> 1);
+
+				// unwrap 33-bit timestamps
+				if ((LastPts >= 0) && (Pts + PtsWraps < LastPts - (1LL << 32)))
+				{
+					PtsWraps += (1LL << 33);
+				}
+
+				Pts += PtsWraps;
+				LastPts = Pts;
+
+				if (FirstPts < 0)
+				{
+					FirstPts = Pts;
+				}
+
+				const int32 HeaderSize = 9 + Payload[8];
+
+				if (!RandomAccess && ((HeaderSize >= PayloadSize) || !HasKeyframeStart(VideoStreamType, Payload + HeaderSize, PayloadSize - HeaderSize)))
+				{
+					continue;
+				}
+
+				const int64 RelativePts = Pts - FirstPts;
+
+				if ((KeyframePts.Num() == 0) || (RelativePts > KeyframePts.Last()))
+				{
+					KeyframePts.Add(RelativePts);
+					OutKeyframes.Emplace(BufferOffset + PacketOffset, FTimespan::Zero());
+				}
+			}
+		}
+	}
+
+	if (VideoPid == -1)
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("No video stream found in %s"), *FilePath);
+		return false;
+	}
+
+	// rebase the key frame times onto the program clock (the first video frame usually follows it by the decoder delay)
+	int64 PcrToPts = 0;
+
+	if ((FirstPcr >= 0) && (FirstPts >= 0))
+	{
+		PcrToPts = FirstPts - FirstPcr;
+
+		if (PcrToPts < -(1LL << 32))
+		{
+			PcrToPts += (1LL << 33); // clocks wrapped in between
+		}
+		else if (PcrToPts > (1LL << 32))
+		{
+			PcrToPts -= (1LL << 33);
+		}
+	}
+
+	for (int32 Index = 0; Index < OutKeyframes.Num(); ++Index)
+	{
+		OutKeyframes[Index].Time = FTimespan((FMath::Max<int64>(0, KeyframePts[Index] + PcrToPts) * ETimespan::TicksPerSecond) / TimestampRate);
+	}
+
+	return true;
+}
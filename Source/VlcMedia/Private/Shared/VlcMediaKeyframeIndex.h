@@ -0,0 +1,183 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/DateTime.h"
+
+
+/**
+ * A key frame in a media file.
+ */
+struct FVlcMediaKeyframe
+{
+	/** Byte offset of the transport packet that starts the key frame. */
+	int64 Offset;
+
+	/** Presentation time relative to the first program clock reference, which is what VLC reports playback times relative to. */
+	FTimespan Time;
+
+	/** Default constructor. */
+	FVlcMediaKeyframe()
+		: Offset(0)
+		, Time(FTimespan::Zero())
+	{ }
+
+	/** Create and initialize a new instance. */
+	FVlcMediaKeyframe(int64 InOffset, FTimespan InTime)
+		: Offset(InOffset)
+		, Time(InTime)
+	{ }
+
+	friend FArchive& operator<<(FArchive& Ar, FVlcMediaKeyframe& Keyframe)
+	{
+		return Ar << Keyframe.Offset << Keyframe.Time;
+	}
+};
+
+
+/**
+ * Index of the key frames in an MPEG transport stream file.
+ *
+ * VLC has to bisect transport streams by their clock references to seek by
+ * time, which takes seconds for large recordings. The index is built once per
+ * file on a background thread by scanning the video elementary stream for
+ * random access points, and it is cached in the project's Saved directory.
+ * Seeks can then jump directly to the byte offset of the nearest key frame,
+ * provided the media was opened with VLC's ts-seek-percent option.
+ */
+class FVlcMediaKeyframeIndex
+{
+public:
+
+	/** Default constructor. */
+	FVlcMediaKeyframeIndex();
+
+	/** Destructor. */
+	~FVlcMediaKeyframeIndex();
+
+public:
+
+	/**
+	 * Load or build the index for the specified file.
+	 *
+	 * A cached index is loaded right away, otherwise the file is indexed in the background.
+	 *
+	 * @param FilePath Path to the media file.
+	 * @see IsAvailable, IsSupported, Reset
+	 */
+	void Build(const FString& FilePath);
+
+	/**
+	 * Find the last key frame at or before the specified time.
+	 *
+	 * @param Time The time to find the key frame for.
+	 * @param OutKeyframe Will contain the key frame.
+	 * @return true if a key frame was found, false if the index is not available.
+	 */
+	bool FindKeyframe(FTimespan Time, FVlcMediaKeyframe& OutKeyframe);
+
+	/**
+	 * Get the average time between key frames.
+	 *
+	 * @return Key frame interval, or zero if the index is not available.
+	 */
+	FTimespan GetAverageInterval();
+
+	/**
+	 * Get the normalized file position of a key frame, as used by VLC's position based seeking.
+	 *
+	 * VLC's TS demuxer only interprets positions as byte offsets if the media
+	 * was opened with the ts-seek-percent option.
+	 *
+	 * @param Keyframe The key frame.
+	 * @return Position in the range [0, 1].
+	 */
+	float GetPosition(const FVlcMediaKeyframe& Keyframe);
+
+	/**
+	 * Check whether the index is available.
+	 *
+	 * @return true if the index was loaded or built, false otherwise.
+	 * @see Build
+	 */
+	bool IsAvailable();
+
+	/** Cancel or discard the current index. */
+	void Reset();
+
+public:
+
+	/**
+	 * Check whether a file can be indexed.
+	 *
+	 * @param FilePath Path to the media file.
+	 * @return true if the file is a transport stream, false otherwise.
+	 */
+	static bool IsSupported(const FString& FilePath);
+
+protected:
+
+	/** Index data for a single file. */
+	struct FData
+	{
+		/** Size of the file when it was indexed. */
+		int64 FileSize;
+
+		/** The key frames, sorted by time. */
+		TArray<FVlcMediaKeyframe> Keyframes;
+
+		/** Modification time of the file when it was indexed. */
+		FDateTime Timestamp;
+
+		/** Default constructor. */
+		FData()
+			: FileSize(0)
+		{ }
+	};
+
+	/** Make the result of the background task available, if it completed. */
+	bool UpdateData();
+
+protected:
+
+	/**
+	 * Build and save the index for a file.
+	 *
+	 * @param FilePath Full path to the media file.
+	 * @param Canceled Flag that is set when the index is no longer needed.
+	 * @return The index data, or nullptr if the file couldn't be indexed.
+	 */
+	static TSharedPtr<FData, ESPMode::ThreadSafe> BuildAndSave(const FString& FilePath, const FThreadSafeBool& Canceled);
+
+	/**
+	 * Load the cached index for a file.
+	 *
+	 * @param FilePath Full path to the media file.
+	 * @return The index data, or nullptr if there is no up-to-date cached index.
+	 */
+	static TSharedPtr<FData, ESPMode::ThreadSafe> Load(const FString& FilePath);
+
+	/**
+	 * Scan a transport stream for key frames.
+	 *
+	 * @param FilePath Full path to the media file.
+	 * @param Canceled Flag that is set when the index is no longer needed.
+	 * @param OutKeyframes Will contain the key frames.
+	 * @return true on success, false otherwise.
+	 */
+	static bool Scan(const FString& FilePath, const FThreadSafeBool& Canceled, TArray<FVlcMediaKeyframe>& OutKeyframes);
+
+private:
+
+	/** Flag that cancels the background task. */
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> Canceled;
+
+	/** The index data (nullptr if not available). */
+	TSharedPtr<FData, ESPMode::ThreadSafe> Data;
+
+	/** Result of the background task. */
+	TFuture<TSharedPtr<FData, ESPMode::ThreadSafe>> Future;
+};
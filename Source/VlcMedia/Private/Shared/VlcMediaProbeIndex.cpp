@@ -0,0 +1,347 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaProbeIndex.h"
+#include "VlcMediaPrivate.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#include "Vlc.h"
+#include "VlcMediaUtils.h"
+
+
+namespace VlcMediaProbeIndex
+{
+	/** Magic number identifying index files. */
+	const uint32 Magic = 0x56505849; // 'VPXI'
+
+	/** Version of the index file format. */
+	const int32 Version = 1;
+
+	/** Get the path of the index file. */
+	FString GetIndexPath()
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VlcMedia"), TEXT("ProbeIndex.bin"));
+	}
+}
+
+
+/* FVlcMediaProbeIndex structors
+ *****************************************************************************/
+
+FVlcMediaProbeIndex::FVlcMediaProbeIndex(FLibvlcInstance* InVlcInstance)
+	: Dirty(false)
+	, VlcInstance(InVlcInstance)
+{ }
+
+
+FVlcMediaProbeIndex::~FVlcMediaProbeIndex()
+{
+	for (TPair<FString, TFuture<FTimespan>>& Pair : PendingIntervals)
+	{
+		Pair.Value.Wait();
+	}
+
+	for (const TPair<FLibvlcMedia*, FString>& Pair : PendingProbes)
+	{
+		FLibvlcEventManager* MediaEventManager = FVlc::MediaEventManager(Pair.Key);
+
+		if (MediaEventManager != nullptr)
+		{
+			FVlc::EventDetach(MediaEventManager, ELibvlcEventType::MediaParsedChanged, &FVlcMediaProbeIndex::StaticEventCallback, this);
+		}
+
+		FVlc::MediaRelease(Pair.Key);
+	}
+}
+
+
+/* FVlcMediaProbeIndex interface
+ *****************************************************************************/
+
+void FVlcMediaProbeIndex::Add(const FString& FilePath, const FVlcMediaInfo& Info)
+{
+	const FString FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+	const int64 Size = IFileManager::Get().FileSize(*FullPath);
+
+	if (Size < 0)
+	{
+		return;
+	}
+
+	const FDateTime Timestamp = IFileManager::Get().GetTimeStamp(*FullPath);
+
+	FScopeLock Lock(&CriticalSection);
+
+	FEntry& Entry = Entries.FindOrAdd(FullPath);
+	{
+		FTimespan KeyframeInterval = FTimespan::Zero();
+
+		if ((Entry.Size == Size) && (Entry.Timestamp == Timestamp) && (Entry.Info.VideoTracks.Num() > 0))
+		{
+			KeyframeInterval = Entry.Info.VideoTracks[0].KeyframeInterval;
+		}
+
+		Entry.Info = Info;
+		Entry.Size = Size;
+		Entry.Timestamp = Timestamp;
+
+		if ((Entry.Info.VideoTracks.Num() > 0) && (Entry.Info.VideoTracks[0].KeyframeInterval == FTimespan::Zero()))
+		{
+			Entry.Info.VideoTracks[0].KeyframeInterval = KeyframeInterval;
+		}
+	}
+
+	Dirty = true;
+
+	RequestKeyframeInterval(FullPath);
+}
+
+
+bool FVlcMediaProbeIndex::Find(const FString& FilePath, FVlcMediaInfo& OutInfo)
+{
+	const FString FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+
+	FScopeLock Lock(&CriticalSection);
+
+	ProcessProbes();
+
+	const FEntry* Entry = Entries.Find(FullPath);
+
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	if ((Entry->Size != IFileManager::Get().FileSize(*FullPath)) || (Entry->Timestamp != IFileManager::Get().GetTimeStamp(*FullPath)))
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Probe index entry for %s is out of date"), *FullPath);
+
+		Entries.Remove(FullPath);
+		Dirty = true;
+
+		return false;
+	}
+
+	OutInfo = Entry->Info;
+
+	return true;
+}
+
+
+void FVlcMediaProbeIndex::Load()
+{
+	const FString IndexPath = VlcMediaProbeIndex::GetIndexPath();
+	TArray<uint8> Buffer;
+
+	if (!FFileHelper::LoadFileToArray(Buffer, *IndexPath, FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Buffer);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+
+	Reader << Magic << Version;
+
+	if ((Magic != VlcMediaProbeIndex::Magic) || (Version != VlcMediaProbeIndex::Version))
+	{
+		UE_LOG(LogVlcMedia, Log, TEXT("Ignoring incompatible probe index %s"), *IndexPath);
+		return;
+	}
+
+	TMap<FString, FEntry> LoadedEntries;
+	Reader << LoadedEntries;
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to read probe index %s"), *IndexPath);
+		return;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	Entries = MoveTemp(LoadedEntries);
+	Dirty = false;
+
+	UE_LOG(LogVlcMedia, Verbose, TEXT("Loaded %i entries from probe index %s"), Entries.Num(), *IndexPath);
+}
+
+
+bool FVlcMediaProbeIndex::Request(const FString& FilePath)
+{
+	FVlcMediaInfo Info;
+
+	if (Find(FilePath, Info))
+	{
+		return true;
+	}
+
+	const FString FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+
+	FScopeLock Lock(&CriticalSection);
+
+	for (const TPair<FLibvlcMedia*, FString>& Pair : PendingProbes)
+	{
+		if (Pair.Value == FullPath)
+		{
+			return false;
+		}
+	}
+
+	FLibvlcMedia* Media = FVlc::MediaNewPath(VlcInstance, TCHAR_TO_UTF8(*FullPath));
+
+	if (Media == nullptr)
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to probe media file %s (%s)"), *FullPath, ANSI_TO_TCHAR(FVlc::Errmsg()));
+		return false;
+	}
+
+	FLibvlcEventManager* MediaEventManager = FVlc::MediaEventManager(Media);
+
+	if (MediaEventManager == nullptr)
+	{
+		FVlc::MediaRelease(Media);
+		return false;
+	}
+
+	FVlc::EventAttach(MediaEventManager, ELibvlcEventType::MediaParsedChanged, &FVlcMediaProbeIndex::StaticEventCallback, this);
+	PendingProbes.Add(Media, FullPath);
+	FVlc::MediaParseAsync(Media);
+
+	return false;
+}
+
+
+void FVlcMediaProbeIndex::Save()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	ProcessProbes();
+
+	if (!Dirty)
+	{
+		return;
+	}
+
+	TArray<uint8> Buffer;
+	FMemoryWriter Writer(Buffer);
+
+	uint32 Magic = VlcMediaProbeIndex::Magic;
+	int32 Version = VlcMediaProbeIndex::Version;
+
+	Writer << Magic << Version << Entries;
+
+	const FString IndexPath = VlcMediaProbeIndex::GetIndexPath();
+
+	if (!FFileHelper::SaveArrayToFile(Buffer, *IndexPath))
+	{
+		UE_LOG(LogVlcMedia, Warning, TEXT("Failed to save probe index %s"), *IndexPath);
+		return;
+	}
+
+	Dirty = false;
+}
+
+
+/* FVlcMediaProbeIndex implementation
+ *****************************************************************************/
+
+void FVlcMediaProbeIndex::ProcessProbes()
+{
+	FLibvlcMedia* Media = nullptr;
+
+	while (ParsedMedia.Dequeue(Media))
+	{
+		FString FullPath;
+
+		if (!PendingProbes.RemoveAndCopyValue(Media, FullPath))
+		{
+			continue;
+		}
+
+		FVlcMediaInfo Info;
+		VlcMedia::ReadMediaInfo(Media, Info);
+
+		FLibvlcEventManager* MediaEventManager = FVlc::MediaEventManager(Media);
+
+		if (MediaEventManager != nullptr)
+		{
+			FVlc::EventDetach(MediaEventManager, ELibvlcEventType::MediaParsedChanged, &FVlcMediaProbeIndex::StaticEventCallback, this);
+		}
+
+		FVlc::MediaRelease(Media);
+
+		if ((Info.AudioTracks.Num() == 0) && (Info.VideoTracks.Num() == 0))
+		{
+			UE_LOG(LogVlcMedia, Verbose, TEXT("Probing %s found no audio or video tracks"), *FullPath);
+			continue;
+		}
+
+		FEntry& Entry = Entries.FindOrAdd(FullPath);
+		{
+			Entry.Info = MoveTemp(Info);
+			Entry.Size = IFileManager::Get().FileSize(*FullPath);
+			Entry.Timestamp = IFileManager::Get().GetTimeStamp(*FullPath);
+		}
+
+		Dirty = true;
+
+		RequestKeyframeInterval(FullPath);
+	}
+
+	for (auto It = PendingIntervals.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsReady())
+		{
+			continue;
+		}
+
+		const FTimespan KeyframeInterval = It.Value().Get();
+		FEntry* Entry = Entries.Find(It.Key());
+
+		if ((Entry != nullptr) && (Entry->Info.VideoTracks.Num() > 0) && (KeyframeInterval > FTimespan::Zero()))
+		{
+			Entry->Info.VideoTracks[0].KeyframeInterval = KeyframeInterval;
+			Dirty = true;
+		}
+
+		It.RemoveCurrent();
+	}
+}
+
+
+void FVlcMediaProbeIndex::RequestKeyframeInterval(const FString& FullPath)
+{
+	const FEntry* Entry = Entries.Find(FullPath);
+
+	if ((Entry == nullptr) || (Entry->Info.VideoTracks.Num() == 0) || (Entry->Info.VideoTracks[0].KeyframeInterval > FTimespan::Zero()) || PendingIntervals.Contains(FullPath))
+	{
+		return;
+	}
+
+	PendingIntervals.Add(FullPath, Async<FTimespan>(EAsyncExecution::ThreadPool, [FullPath]() {
+		return VlcMedia::ReadKeyframeInterval(FullPath);
+	}));
+}
+
+
+/* FVlcMediaProbeIndex static functions
+ *****************************************************************************/
+
+void FVlcMediaProbeIndex::StaticEventCallback(FLibvlcEvent* Event, void* UserData)
+{
+	if ((Event == nullptr) || (UserData == nullptr) || (Event->Type != ELibvlcEventType::MediaParsedChanged))
+	{
+		return;
+	}
+
+	((FVlcMediaProbeIndex*)UserData)->ParsedMedia.Enqueue((FLibvlcMedia*)Event->Obj);
+}
@@ -0,0 +1,144 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Containers/Queue.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/DateTime.h"
+
+#include "VlcMediaInfo.h"
+
+struct FLibvlcEvent;
+struct FLibvlcInstance;
+struct FLibvlcMedia;
+
+
+/**
+ * Persistent index of media file information.
+ *
+ * Entries are keyed by the full path of a media file and are only valid as
+ * long as the file's size and modification time don't change. The index is
+ * filled by media players once VLC finished parsing a file, and by probing
+ * files in the background on request. Key frame intervals are read from the
+ * files' containers on the thread pool and filled in once they are known. The
+ * index is loaded from and saved to the project's Saved directory.
+ */
+class FVlcMediaProbeIndex
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InVlcInstance The LibVLC instance to use for probing files.
+	 */
+	FVlcMediaProbeIndex(FLibvlcInstance* InVlcInstance);
+
+	/** Destructor. */
+	~FVlcMediaProbeIndex();
+
+public:
+
+	/**
+	 * Add or replace the information for a media file.
+	 *
+	 * If the first video track has no key frame interval, the interval of the
+	 * existing entry is kept, or read from the file in the background.
+	 *
+	 * @param FilePath Path to the media file.
+	 * @param Info The media information.
+	 */
+	void Add(const FString& FilePath, const FVlcMediaInfo& Info);
+
+	/**
+	 * Find the information for a media file.
+	 *
+	 * @param FilePath Path to the media file.
+	 * @param OutInfo Will contain the media information.
+	 * @return true if up-to-date information was found, false otherwise.
+	 * @see Request
+	 */
+	bool Find(const FString& FilePath, FVlcMediaInfo& OutInfo);
+
+	/** Load the index from disk. */
+	void Load();
+
+	/**
+	 * Probe a media file in the background if it isn't indexed yet.
+	 *
+	 * @param FilePath Path to the media file.
+	 * @return true if the file is indexed already, false if it is being probed.
+	 * @see Find
+	 */
+	bool Request(const FString& FilePath);
+
+	/** Save the index to disk if it changed. */
+	void Save();
+
+protected:
+
+	/** Collect the results of completed background probes. */
+	void ProcessProbes();
+
+	/**
+	 * Read the key frame interval of an indexed file in the background.
+	 *
+	 * The caller must hold the lock.
+	 *
+	 * @param FullPath Full path to the media file.
+	 */
+	void RequestKeyframeInterval(const FString& FullPath);
+
+private:
+
+	/** Handles parse events of probed media. */
+	static void StaticEventCallback(FLibvlcEvent* Event, void* UserData);
+
+private:
+
+	/** An index entry. */
+	struct FEntry
+	{
+		/** The media information. */
+		FVlcMediaInfo Info;
+
+		/** Size of the file when it was indexed. */
+		int64 Size;
+
+		/** Modification time of the file when it was indexed. */
+		FDateTime Timestamp;
+
+		/** Default constructor. */
+		FEntry()
+			: Size(0)
+		{ }
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+		{
+			return Ar << Entry.Info << Entry.Size << Entry.Timestamp;
+		}
+	};
+
+	/** Synchronizes access to the index. */
+	FCriticalSection CriticalSection;
+
+	/** Whether the index changed since it was last saved. */
+	bool Dirty;
+
+	/** The index entries by full file path. */
+	TMap<FString, FEntry> Entries;
+
+	/** Media objects that finished parsing. */
+	TQueue<FLibvlcMedia*, EQueueMode::Mpsc> ParsedMedia;
+
+	/** Key frame intervals being read, by full file path. */
+	TMap<FString, TFuture<FTimespan>> PendingIntervals;
+
+	/** Media objects being probed, and their file paths. */
+	TMap<FLibvlcMedia*, FString> PendingProbes;
+
+	/** The LibVLC instance. */
+	FLibvlcInstance* VlcInstance;
+};
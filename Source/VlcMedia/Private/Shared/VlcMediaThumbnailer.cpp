@@ -0,0 +1,357 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "VlcMediaThumbnailer.h"
+#include "VlcMediaPrivate.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+
+#include "Vlc.h"
+
+
+namespace VlcMediaThumbnailer
+{
+	/** Maximum number of cached thumbnails. */
+	const int32 MaxCacheEntries = 512;
+
+	/** Maximum number of players that extract thumbnails at the same time. */
+	const int32 MaxWorkers = 2;
+
+	/** Time after which a request is abandoned (in seconds). */
+	const double Timeout = 10.0;
+}
+
+
+/* FVlcMediaThumbnailer structors
+ *****************************************************************************/
+
+FVlcMediaThumbnailer::FVlcMediaThumbnailer(FLibvlcInstance* InVlcInstance)
+	: UseCounter(0)
+	, VlcInstance(InVlcInstance)
+{
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FVlcMediaThumbnailer::HandleTicker));
+}
+
+
+FVlcMediaThumbnailer::~FVlcMediaThumbnailer()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	// the LibVLC instance is released after this, so the players can't outlive the thumbnailer
+	for (const TUniquePtr<FWorker>& Worker : Workers)
+	{
+		if (Worker->Stopped.IsValid())
+		{
+			Worker->Stopped.Wait();
+		}
+
+		FVlc::MediaPlayerStop(Worker->Player);
+		FVlc::MediaPlayerRelease(Worker->Player);
+	}
+}
+
+
+/* FVlcMediaThumbnailer interface
+ *****************************************************************************/
+
+void FVlcMediaThumbnailer::Request(const FString& Url, FTimespan Time, int32 MaxDim, const FOnVlcMediaThumbnail& Delegate)
+{
+	const FString Key = FString::Printf(TEXT("%s|%lli|%i"), *Url, Time.GetTicks(), MaxDim);
+
+	// serve from cache
+	FCacheEntry* Entry = Cache.Find(Key);
+
+	if (Entry != nullptr)
+	{
+		Entry->LastUse = ++UseCounter;
+		Delegate.ExecuteIfBound(Entry->Thumbnail);
+
+		return;
+	}
+
+	// join identical requests
+	auto IsSameRequest = [&](const TSharedPtr<FRequest>& Other) { return Other.IsValid() && (Other->Key == Key); };
+
+	for (const TSharedRef<FRequest>& Pending : PendingRequests)
+	{
+		if (IsSameRequest(Pending))
+		{
+			Pending->Delegates.Add(Delegate);
+			return;
+		}
+	}
+
+	for (const TUniquePtr<FWorker>& Worker : Workers)
+	{
+		if (IsSameRequest(Worker->Request))
+		{
+			Worker->Request->Delegates.Add(Delegate);
+			return;
+		}
+	}
+
+	TSharedRef<FRequest> Request = MakeShared<FRequest>();
+	{
+		Request->Delegates.Add(Delegate);
+		Request->Key = Key;
+		Request->MaxDim = MaxDim;
+		Request->Time = Time;
+		Request->Url = Url;
+	}
+
+	PendingRequests.Add(Request);
+}
+
+
+/* FVlcMediaThumbnailer implementation
+ *****************************************************************************/
+
+void FVlcMediaThumbnailer::AddToCache(const FString& Key, const TSharedRef<const FVlcMediaThumbnail, ESPMode::ThreadSafe>& Thumbnail)
+{
+	FCacheEntry& Entry = Cache.FindOrAdd(Key);
+	{
+		Entry.LastUse = ++UseCounter;
+		Entry.Thumbnail = Thumbnail;
+	}
+
+	while (Cache.Num() > VlcMediaThumbnailer::MaxCacheEntries)
+	{
+		const FString* OldestKey = nullptr;
+		uint64 OldestUse = MAX_uint64;
+
+		for (const auto& Pair : Cache)
+		{
+			if (Pair.Value.LastUse < OldestUse)
+			{
+				OldestKey = &Pair.Key;
+				OldestUse = Pair.Value.LastUse;
+			}
+		}
+
+		Cache.Remove(FString(*OldestKey));
+	}
+}
+
+
+void FVlcMediaThumbnailer::CompleteRequest(FWorker& Worker, bool Succeeded)
+{
+	TSharedPtr<const FVlcMediaThumbnail, ESPMode::ThreadSafe> Result;
+
+	if (Succeeded)
+	{
+		const int64 Time = FVlc::MediaPlayerGetTime(Worker.Player);
+
+		TSharedRef<FVlcMediaThumbnail, ESPMode::ThreadSafe> Thumbnail = MakeShared<FVlcMediaThumbnail, ESPMode::ThreadSafe>();
+		{
+			Thumbnail->Buffer.Append(Worker.Buffer.GetData(), Worker.Dim.X * Worker.Dim.Y * 4);
+			Thumbnail->Dim = Worker.Dim;
+			Thumbnail->Time = (Time > 0) ? FTimespan(Time * ETimespan::TicksPerMillisecond) : Worker.Request->Time;
+		}
+
+		AddToCache(Worker.Request->Key, Thumbnail);
+		Result = Thumbnail;
+	}
+	else
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Failed to extract thumbnail at %s from %s"), *Worker.Request->Time.ToString(), *Worker.Request->Url);
+	}
+
+	// stopping waits for VLC's input thread, so do it off the game thread; the worker stays busy until then
+	FLibvlcMediaPlayer* Player = Worker.Player;
+
+	Worker.Stopped = Async<void>(EAsyncExecution::ThreadPool, [Player]() {
+		FVlc::MediaPlayerStop(Player);
+		FVlc::MediaPlayerSetMedia(Player, nullptr);
+	});
+
+	TSharedPtr<FRequest> Request = Worker.Request;
+	Worker.Request.Reset();
+
+	for (const FOnVlcMediaThumbnail& Delegate : Request->Delegates)
+	{
+		Delegate.ExecuteIfBound(Result);
+	}
+}
+
+
+bool FVlcMediaThumbnailer::IsIdle(const FWorker& Worker)
+{
+	return !Worker.Request.IsValid() && (!Worker.Stopped.IsValid() || Worker.Stopped.IsReady());
+}
+
+
+bool FVlcMediaThumbnailer::StartRequest(FWorker& Worker, const TSharedRef<FRequest>& Request)
+{
+	FLibvlcMedia* Media = Request->Url.StartsWith(TEXT("file://"))
+		? FVlc::MediaNewPath(VlcInstance, TCHAR_TO_UTF8(&Request->Url[7]))
+		: FVlc::MediaNewLocation(VlcInstance, TCHAR_TO_ANSI(*Request->Url));
+
+	if (Media == nullptr)
+	{
+		UE_LOG(LogVlcMedia, Verbose, TEXT("Failed to open media for thumbnail: %s (%s)"), *Request->Url, ANSI_TO_TCHAR(FVlc::Errmsg()));
+		return false;
+	}
+
+	FVlc::MediaAddOption(Media, ":no-audio");
+	FVlc::MediaAddOption(Media, ":no-spu");
+	FVlc::MediaAddOption(Media, ":input-fast-seek"); // start at the nearest key frame
+	FVlc::MediaAddOption(Media, TCHAR_TO_ANSI(*FString::Printf(TEXT(":start-time=%.3f"), Request->Time.GetTotalSeconds())));
+
+	FVlc::MediaPlayerSetMedia(Worker.Player, Media);
+	FVlc::MediaRelease(Media);
+
+	Worker.Captured = false;
+	Worker.Locked = false;
+	Worker.MaxDim = Request->MaxDim;
+	Worker.Request = Request;
+	Worker.StartSeconds = FPlatformTime::Seconds();
+	Worker.Stopped = TFuture<void>();
+
+	return (FVlc::MediaPlayerPlay(Worker.Player) != -1);
+}
+
+
+/* FVlcMediaThumbnailer callbacks
+ *****************************************************************************/
+
+bool FVlcMediaThumbnailer::HandleTicker(float /*DeltaTime*/)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	// collect completed requests
+	for (const TUniquePtr<FWorker>& Worker : Workers)
+	{
+		if (!Worker->Request.IsValid())
+		{
+			continue;
+		}
+
+		if (Worker->Captured)
+		{
+			CompleteRequest(*Worker, true);
+		}
+		else
+		{
+			const ELibvlcState State = FVlc::MediaPlayerGetState(Worker->Player);
+
+			if ((State == ELibvlcState::Ended) || (State == ELibvlcState::Error) || (Now - Worker->StartSeconds > VlcMediaThumbnailer::Timeout))
+			{
+				CompleteRequest(*Worker, false);
+			}
+		}
+	}
+
+	// hand pending requests to idle workers
+	while (PendingRequests.Num() > 0)
+	{
+		FWorker* IdleWorker = nullptr;
+
+		for (const TUniquePtr<FWorker>& Worker : Workers)
+		{
+			if (IsIdle(*Worker))
+			{
+				IdleWorker = Worker.Get();
+				break;
+			}
+		}
+
+		if ((IdleWorker == nullptr) && (Workers.Num() < VlcMediaThumbnailer::MaxWorkers))
+		{
+			FLibvlcMediaPlayer* Player = FVlc::MediaPlayerNew(VlcInstance);
+
+			if (Player == nullptr)
+			{
+				UE_LOG(LogVlcMedia, Warning, TEXT("Failed to create thumbnail player: %s"), ANSI_TO_TCHAR(FVlc::Errmsg()));
+				break;
+			}
+
+			TUniquePtr<FWorker> Worker = MakeUnique<FWorker>();
+			{
+				Worker->Dim = FIntPoint::ZeroValue;
+				Worker->MaxDim = 0;
+				Worker->Player = Player;
+				Worker->StartSeconds = 0.0;
+			}
+
+			FVlc::VideoSetFormatCallbacks(Player, &FVlcMediaThumbnailer::StaticSetupCallback, nullptr);
+			FVlc::VideoSetCallbacks(Player, &FVlcMediaThumbnailer::StaticLockCallback, &FVlcMediaThumbnailer::StaticUnlockCallback, nullptr, Worker.Get());
+
+			IdleWorker = Worker.Get();
+			Workers.Add(MoveTemp(Worker));
+		}
+
+		if (IdleWorker == nullptr)
+		{
+			break; // all workers are busy
+		}
+
+		TSharedRef<FRequest> Request = PendingRequests[0];
+		PendingRequests.RemoveAt(0);
+
+		if (!StartRequest(*IdleWorker, Request))
+		{
+			IdleWorker->Request = Request;
+			CompleteRequest(*IdleWorker, false);
+		}
+	}
+
+	return true;
+}
+
+
+void* FVlcMediaThumbnailer::StaticLockCallback(void* Opaque, void** Planes)
+{
+	auto Worker = (FWorker*)Opaque;
+
+	// decoders may lock several pictures ahead, so only the first one is captured
+	if (!Worker->Locked.AtomicSet(true))
+	{
+		Planes[0] = Worker->Buffer.GetData();
+	}
+	else
+	{
+		Planes[0] = Worker->Scratch.GetData();
+	}
+
+	return Planes[0];
+}
+
+
+unsigned FVlcMediaThumbnailer::StaticSetupCallback(void** Opaque, char* Chroma, unsigned* Width, unsigned* Height, unsigned* Pitches, unsigned* Lines)
+{
+	auto Worker = *(FWorker**)Opaque;
+
+	if ((Worker == nullptr) || (*Width == 0) || (*Height == 0))
+	{
+		return 0;
+	}
+
+	// let VLC scale the frames to the requested size
+	const float Scale = (Worker->MaxDim > 0) ? FMath::Min(1.0f, (float)Worker->MaxDim / FMath::Max(*Width, *Height)) : 1.0f;
+
+	Worker->Dim.X = FMath::Max(1, FMath::RoundToInt(*Width * Scale));
+	Worker->Dim.Y = FMath::Max(1, FMath::RoundToInt(*Height * Scale));
+
+	FMemory::Memcpy(Chroma, "RV32", 4);
+
+	*Width = Worker->Dim.X;
+	*Height = Worker->Dim.Y;
+	Pitches[0] = Worker->Dim.X * 4;
+	Lines[0] = Worker->Dim.Y;
+
+	Worker->Buffer.SetNumUninitialized(Pitches[0] * Lines[0]);
+	Worker->Scratch.SetNumUninitialized(Pitches[0] * Lines[0]);
+
+	return 1;
+}
+
+
+void FVlcMediaThumbnailer::StaticUnlockCallback(void* Opaque, void* Picture, void* const* /*Planes*/)
+{
+	auto Worker = (FWorker*)Opaque;
+
+	if (Picture == Worker->Buffer.GetData())
+	{
+		Worker->Captured = true;
+	}
+}
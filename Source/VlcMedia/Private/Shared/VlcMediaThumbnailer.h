@@ -0,0 +1,189 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+#include "HAL/ThreadSafeBool.h"
+
+#include "VlcMediaThumbnail.h"
+
+struct FLibvlcInstance;
+struct FLibvlcMediaPlayer;
+
+
+/**
+ * Extracts thumbnails from media sources in the background.
+ *
+ * Requests are served by a small pool of VLC players that have audio
+ * disabled and render directly into BGRA buffers of the requested size, so
+ * VLC scales the frames while converting them. Each player seeks to the key
+ * frame nearest to the requested time and captures the first decoded frame.
+ * Completed thumbnails are kept in a least recently used cache.
+ *
+ * The players use their own video callbacks rather than FVlcMediaCallbacks,
+ * which outputs YUV for most sources and runs the sample queues, pools and
+ * delivery pacing of a playing media source. A thumbnail only needs a single
+ * BGRA frame that can be handed out as is.
+ */
+class FVlcMediaThumbnailer
+{
+public:
+
+	/**
+	 * Create and initialize a new instance.
+	 *
+	 * @param InVlcInstance The LibVLC instance to use.
+	 */
+	FVlcMediaThumbnailer(FLibvlcInstance* InVlcInstance);
+
+	/** Destructor. */
+	~FVlcMediaThumbnailer();
+
+public:
+
+	/**
+	 * Request a thumbnail.
+	 *
+	 * If the thumbnail is cached, the delegate is executed immediately.
+	 *
+	 * @param Url The URL of the media source.
+	 * @param Time The time of the frame to extract.
+	 * @param MaxDim The maximum width or height of the thumbnail (0 = source size).
+	 * @param Delegate The delegate to execute when the thumbnail is available.
+	 */
+	void Request(const FString& Url, FTimespan Time, int32 MaxDim, const FOnVlcMediaThumbnail& Delegate);
+
+protected:
+
+	/** A thumbnail request. */
+	struct FRequest
+	{
+		/** The delegates to execute on completion. */
+		TArray<FOnVlcMediaThumbnail> Delegates;
+
+		/** Cache key of the request. */
+		FString Key;
+
+		/** Maximum width or height of the thumbnail. */
+		int32 MaxDim;
+
+		/** Time of the frame to extract. */
+		FTimespan Time;
+
+		/** The media URL. */
+		FString Url;
+	};
+
+	/** A pooled player that extracts thumbnails. */
+	struct FWorker
+	{
+		/** The buffer that receives the captured frame. */
+		TArray<uint8> Buffer;
+
+		/** Whether a frame was decoded into the buffer. */
+		FThreadSafeBool Captured;
+
+		/** Dimensions of the captured frame. */
+		FIntPoint Dim;
+
+		/** Whether the buffer was handed to the decoder. */
+		FThreadSafeBool Locked;
+
+		/** Maximum width or height of the current request. */
+		int32 MaxDim;
+
+		/** The VLC media player object. */
+		FLibvlcMediaPlayer* Player;
+
+		/** The request being processed (if any). */
+		TSharedPtr<FRequest> Request;
+
+		/** Buffer that receives all frames after the captured one. */
+		TArray<uint8> Scratch;
+
+		/** Time when the current request started (in seconds). */
+		double StartSeconds;
+
+		/** Completes when the player stopped after the previous request. */
+		TFuture<void> Stopped;
+	};
+
+	/**
+	 * Add a thumbnail to the cache and evict the least recently used ones.
+	 *
+	 * @param Key The cache key.
+	 * @param Thumbnail The thumbnail to add.
+	 */
+	void AddToCache(const FString& Key, const TSharedRef<const FVlcMediaThumbnail, ESPMode::ThreadSafe>& Thumbnail);
+
+	/**
+	 * Complete a worker's request and execute its delegates.
+	 *
+	 * @param Worker The worker whose request completed.
+	 * @param Succeeded Whether a frame was captured.
+	 */
+	void CompleteRequest(FWorker& Worker, bool Succeeded);
+
+	/**
+	 * Check whether a worker can start a new request.
+	 *
+	 * @param Worker The worker to check.
+	 * @return true if the worker is idle, false otherwise.
+	 */
+	static bool IsIdle(const FWorker& Worker);
+
+	/**
+	 * Start processing a request.
+	 *
+	 * @param Worker The worker to process the request.
+	 * @param Request The request to process.
+	 * @return true on success, false otherwise.
+	 */
+	bool StartRequest(FWorker& Worker, const TSharedRef<FRequest>& Request);
+
+private:
+
+	/** Callback for the core ticker. */
+	bool HandleTicker(float DeltaTime);
+
+	/** Handles video lock callbacks from VLC. */
+	static void* StaticLockCallback(void* Opaque, void** Planes);
+
+	/** Handles video format setup callbacks from VLC. */
+	static unsigned StaticSetupCallback(void** Opaque, char* Chroma, unsigned* Width, unsigned* Height, unsigned* Pitches, unsigned* Lines);
+
+	/** Handles video unlock callbacks from VLC. */
+	static void StaticUnlockCallback(void* Opaque, void* Picture, void* const* Planes);
+
+private:
+
+	/** A cached thumbnail. */
+	struct FCacheEntry
+	{
+		/** The thumbnail. */
+		TSharedPtr<const FVlcMediaThumbnail, ESPMode::ThreadSafe> Thumbnail;
+
+		/** Value of the use counter when the thumbnail was last used. */
+		uint64 LastUse;
+	};
+
+	/** Cached thumbnails by request key. */
+	TMap<FString, FCacheEntry> Cache;
+
+	/** Requests that wait for a worker. */
+	TArray<TSharedRef<FRequest>> PendingRequests;
+
+	/** Handle to the registered ticker. */
+	FDelegateHandle TickerHandle;
+
+	/** Counter that orders cache accesses. */
+	uint64 UseCounter;
+
+	/** The LibVLC instance. */
+	FLibvlcInstance* VlcInstance;
+
+	/** The worker pool. */
+	TArray<TUniquePtr<FWorker>> Workers;
+};
@@ -1,8 +1,186 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "VlcMediaUtils.h"
+#include "VlcMediaPrivate.h"
 #include "VlcTypes.h"
 
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Templates/UniquePtr.h"
+
+#include "Vlc.h"
+#include "VlcMediaInfo.h"
+
+
+namespace VlcMediaUtils
+{
+	/** Sync sample statistics of an ISO base media file track. */
+	struct FIsoTrack
+	{
+		/** Track duration (in time scale units). */
+		uint64 Duration;
+
+		/** Whether the track has a sync sample table (without one, all samples are sync samples). */
+		bool HasSyncTable;
+
+		/** Whether this is a video track. */
+		bool IsVideo;
+
+		/** Number of samples. */
+		uint32 NumSamples;
+
+		/** Number of sync samples. */
+		uint32 NumSyncSamples;
+
+		/** Number of time scale units per second. */
+		uint32 Timescale;
+
+		/** Default constructor. */
+		FIsoTrack()
+			: Duration(0)
+			, HasSyncTable(false)
+			, IsVideo(false)
+			, NumSamples(0)
+			, NumSyncSamples(0)
+			, Timescale(0)
+		{ }
+	};
+
+	/** Read a big endian integer of the given size (in bytes). */
+	uint64 ReadBigEndian(FArchive& Ar, int32 Size)
+	{
+		check(Size <= 8);
+
+		uint8 Bytes[8] = { 0 };
+		Ar.Serialize(Bytes, Size);
+
+		uint64 Value = 0;
+
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			Value = (Value << 8) | Bytes[Index];
+		}
+
+		return Value;
+	}
+
+	/**
+	 * Read the boxes of an ISO base media file (MP4, MOV) in the given range.
+	 *
+	 * Only the boxes that lead to a video track's duration and sync sample
+	 * table are parsed; everything else, including the media data, is skipped.
+	 *
+	 * @param Ar The archive to read from.
+	 * @param End The offset at which the range ends.
+	 * @param Track The track whose boxes are being read (nullptr outside of tracks).
+	 * @param OutInterval Will contain the average key frame interval of the first video track.
+	 * @return false if the file is malformed, true otherwise.
+	 */
+	bool ReadIsoBoxes(FArchive& Ar, int64 End, FIsoTrack* Track, FTimespan& OutInterval)
+	{
+		while ((Ar.Tell() + 8 <= End) && !Ar.IsError() && (OutInterval == FTimespan::Zero()))
+		{
+			const int64 Start = Ar.Tell();
+			uint64 Size = ReadBigEndian(Ar, 4);
+			const uint32 Type = (uint32)ReadBigEndian(Ar, 4);
+
+			if (Size == 1)
+			{
+				Size = ReadBigEndian(Ar, 8);
+			}
+			else if (Size == 0)
+			{
+				Size = End - Start;
+			}
+
+			const int64 BoxEnd = Start + (int64)Size;
+
+			if ((Size < 8) || (BoxEnd > End))
+			{
+				return false;
+			}
+
+			switch (Type)
+			{
+			case 0x6d6f6f76: // moov
+			case 0x6d646961: // mdia
+			case 0x6d696e66: // minf
+			case 0x7374626c: // stbl
+				if (!ReadIsoBoxes(Ar, BoxEnd, Track, OutInterval))
+				{
+					return false;
+				}
+				break;
+
+			case 0x7472616b: // trak
+				{
+					FIsoTrack NewTrack;
+
+					if (!ReadIsoBoxes(Ar, BoxEnd, &NewTrack, OutInterval))
+					{
+						return false;
+					}
+
+					const uint32 NumKeyframes = NewTrack.HasSyncTable ? NewTrack.NumSyncSamples : NewTrack.NumSamples;
+
+					if (NewTrack.IsVideo && (NewTrack.Timescale > 0) && (NumKeyframes > 0))
+					{
+						OutInterval = FTimespan::FromSeconds((double)NewTrack.Duration / NewTrack.Timescale / NumKeyframes);
+					}
+				}
+				break;
+
+			case 0x68646c72: // hdlr
+				if (Track != nullptr)
+				{
+					ReadBigEndian(Ar, 8); // version, flags, pre-defined
+
+					// QuickTime files also have data handlers in their minf boxes
+					if (ReadBigEndian(Ar, 4) == 0x76696465) // vide
+					{
+						Track->IsVideo = true;
+					}
+				}
+				break;
+
+			case 0x6d646864: // mdhd
+				if (Track != nullptr)
+				{
+					const bool Version1 = (ReadBigEndian(Ar, 4) >> 24) == 1;
+					Ar.Seek(Ar.Tell() + (Version1 ? 16 : 8)); // creation & modification time
+					Track->Timescale = (uint32)ReadBigEndian(Ar, 4);
+					Track->Duration = ReadBigEndian(Ar, Version1 ? 8 : 4);
+				}
+				break;
+
+			case 0x7374737a: // stsz
+				if (Track != nullptr)
+				{
+					ReadBigEndian(Ar, 8); // version, flags, sample size
+					Track->NumSamples = (uint32)ReadBigEndian(Ar, 4);
+				}
+				break;
+
+			case 0x73747373: // stss
+				if (Track != nullptr)
+				{
+					ReadBigEndian(Ar, 4); // version, flags
+					Track->HasSyncTable = true;
+					Track->NumSyncSamples = (uint32)ReadBigEndian(Ar, 4);
+				}
+				break;
+
+			default:
+				break;
+			}
+
+			Ar.Seek(BoxEnd);
+		}
+
+		return !Ar.IsError();
+	}
+}
+
 
 namespace VlcMedia
 {
@@ -78,6 +256,144 @@ namespace VlcMedia
 	}
 
 
+	uint64 HashFrame(const void* Data, SIZE_T Size)
+	{
+		const uint64 Prime = 0x9e3779b97f4a7c15ull;
+
+		// four independent lanes keep the multipliers busy
+		uint64 Lanes[4] = { 1, 2, 3, 4 };
+
+		const uint64* Words = (const uint64*)Data;
+		const SIZE_T NumBlocks = Size / 32;
+
+		for (SIZE_T BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex, Words += 4)
+		{
+			Lanes[0] = (Lanes[0] ^ Words[0]) * Prime;
+			Lanes[1] = (Lanes[1] ^ Words[1]) * Prime;
+			Lanes[2] = (Lanes[2] ^ Words[2]) * Prime;
+			Lanes[3] = (Lanes[3] ^ Words[3]) * Prime;
+		}
+
+		uint64 Hash = Size;
+
+		for (const uint8* Byte = (const uint8*)Words; Byte < (const uint8*)Data + Size; ++Byte)
+		{
+			Hash = (Hash ^ *Byte) * Prime;
+		}
+
+		for (uint64 Lane : Lanes)
+		{
+			Hash = ((Hash ^ Lane) * Prime) ^ (Hash >> 29);
+		}
+
+		return Hash;
+	}
+
+
+	FTimespan ReadKeyframeInterval(const FString& FilePath)
+	{
+		static const TCHAR* IsoExtensions[] = { TEXT("3gp"), TEXT("m4a"), TEXT("m4v"), TEXT("mov"), TEXT("mp4") };
+
+		const FString Extension = FPaths::GetExtension(FilePath);
+		bool IsIsoFile = false;
+
+		for (const TCHAR* IsoExtension : IsoExtensions)
+		{
+			IsIsoFile |= Extension.Equals(IsoExtension, ESearchCase::IgnoreCase);
+		}
+
+		if (!IsIsoFile)
+		{
+			return FTimespan::Zero();
+		}
+
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+
+		if (!Reader.IsValid())
+		{
+			return FTimespan::Zero();
+		}
+
+		FTimespan Interval = FTimespan::Zero();
+
+		if (!VlcMediaUtils::ReadIsoBoxes(*Reader, Reader->TotalSize(), nullptr, Interval))
+		{
+			UE_LOG(LogVlcMedia, Verbose, TEXT("Failed to read the sync sample table of %s"), *FilePath);
+		}
+
+		return Interval;
+	}
+
+
+	void ReadMediaInfo(FLibvlcMedia* Media, FVlcMediaInfo& OutInfo)
+	{
+		const int64 Duration = FVlc::MediaGetDuration(Media);
+		OutInfo.Duration = (Duration > 0) ? FTimespan(Duration * ETimespan::TicksPerMillisecond) : FTimespan::Zero();
+
+		FLibvlcMediaTrack** MediaTracks = nullptr;
+		const uint32 NumMediaTracks = FVlc::MediaTracksGet(Media, &MediaTracks);
+
+		for (uint32 MediaTrackIndex = 0; MediaTrackIndex < NumMediaTracks; ++MediaTrackIndex)
+		{
+			const FLibvlcMediaTrack* MediaTrack = MediaTracks[MediaTrackIndex];
+			FVlcMediaTrackInfo Track;
+
+			Track.BitRate = MediaTrack->Bitrate;
+			Track.Id = MediaTrack->Id;
+			Track.Language = (MediaTrack->Language != nullptr) ? ANSI_TO_TCHAR(MediaTrack->Language) : TEXT("");
+			Track.Name = (MediaTrack->Description != nullptr) ? ANSI_TO_TCHAR(MediaTrack->Description) : TEXT("");
+
+			const ANSICHAR* CodecDescr = FVlc::MediaGetCodecDescription(MediaTrack->Type, MediaTrack->Codec);
+
+			if (CodecDescr != nullptr)
+			{
+				Track.TypeName = ANSI_TO_TCHAR(CodecDescr);
+			}
+			else
+			{
+				ANSICHAR Fourcc[5] = { 0 };
+				FMemory::Memcpy(Fourcc, &MediaTrack->Codec, 4);
+				Track.TypeName = ANSI_TO_TCHAR(Fourcc);
+			}
+
+			switch (MediaTrack->Type)
+			{
+			case ELibvlcTrackType::Audio:
+				if (MediaTrack->Audio != nullptr)
+				{
+					Track.NumChannels = MediaTrack->Audio->Channels;
+					Track.SampleRate = MediaTrack->Audio->Rate;
+				}
+				OutInfo.AudioTracks.Add(Track);
+				break;
+
+			case ELibvlcTrackType::Text:
+				OutInfo.CaptionTracks.Add(Track);
+				break;
+
+			case ELibvlcTrackType::Video:
+				if (MediaTrack->Video != nullptr)
+				{
+					Track.Dim = FIntPoint(MediaTrack->Video->Width, MediaTrack->Video->Height);
+					Track.FrameRate = (MediaTrack->Video->FrameRateDen > 0)
+						? (float)MediaTrack->Video->FrameRateNum / (float)MediaTrack->Video->FrameRateDen
+						: 0.0f;
+				}
+				OutInfo.VideoTracks.Add(Track);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		if (MediaTracks != nullptr)
+		{
+			FVlc::MediaTracksRelease(MediaTracks, NumMediaTracks);
+		}
+	}
+
+
 	FString StateToString(ELibvlcState State)
 	{
 		switch (State)
@@ -7,6 +7,8 @@
 
 enum class ELibvlcState;
 struct FLibvlcEvent;
+struct FLibvlcMedia;
+struct FVlcMediaInfo;
 
 
 namespace VlcMedia
@@ -19,6 +21,40 @@ namespace VlcMedia
 	 */
 	FString EventToString(FLibvlcEvent* Event);
 
+	/**
+	 * Calculate a 64-bit hash of a video frame.
+	 *
+	 * This is meant for detecting identical frames quickly, not for security.
+	 *
+	 * @param Data The frame data (must be 8-byte aligned).
+	 * @param Size Size of the frame data (in bytes).
+	 * @return The hash value.
+	 */
+	uint64 HashFrame(const void* Data, SIZE_T Size);
+
+	/**
+	 * Read the average key frame interval of a media file's first video track.
+	 *
+	 * VLC doesn't expose the GOP structure of its streams, so this reads it
+	 * from the container instead. Currently only MP4 and QuickTime files are
+	 * supported, whose sync sample tables list all key frames.
+	 *
+	 * @param FilePath The path of the media file.
+	 * @return Average time between key frames, or zero if unknown.
+	 */
+	FTimespan ReadKeyframeInterval(const FString& FilePath);
+
+	/**
+	 * Read the duration and elementary stream formats of a media.
+	 *
+	 * The media must have been parsed for this to return useful results.
+	 * Subtitle streams are added as caption tracks.
+	 *
+	 * @param Media The media to read.
+	 * @param OutInfo Will contain the media information.
+	 */
+	void ReadMediaInfo(FLibvlcMedia* Media, FVlcMediaInfo& OutInfo);
+
 	/**
 	 * Convert a LibVLC state to string.
 	 *
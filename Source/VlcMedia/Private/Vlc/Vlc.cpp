@@ -60,7 +60,9 @@ VLC_DEFINE(GetVersion)
 
 VLC_DEFINE(Clock)
 
+VLC_DEFINE(MediaAddOption)
 VLC_DEFINE(MediaEventManager)
+VLC_DEFINE(MediaGetCodecDescription)
 VLC_DEFINE(MediaGetDuration)
 VLC_DEFINE(MediaGetStats)
 VLC_DEFINE(MediaNewCallbacks)
@@ -196,7 +198,9 @@ bool FVlc::Initialize()
 
 	VLC_IMPORT(libvlc_clock, Clock)
 
+	VLC_IMPORT(libvlc_media_add_option, MediaAddOption)
 	VLC_IMPORT(libvlc_media_event_manager, MediaEventManager)
+	VLC_IMPORT(libvlc_media_get_codec_description, MediaGetCodecDescription)
 	VLC_IMPORT(libvlc_media_get_duration, MediaGetDuration)
 	VLC_IMPORT(libvlc_media_get_stats, MediaGetStats)
 	VLC_IMPORT(libvlc_media_new_callbacks, MediaNewCallbacks)
@@ -43,7 +43,9 @@ public:
 
 	static FLibvlcClockProc Clock;
 
+	static FLibvlcMediaAddOptionProc MediaAddOption;
 	static FLibvlcMediaEventManagerProc MediaEventManager;
+	static FLibvlcMediaGetCodecDescriptionProc MediaGetCodecDescription;
 	static FLibvlcMediaGetDurationProc MediaGetDuration;
 	static FLibvlcMediaGetStatsProc MediaGetStats;
 	static FLibvlcMediaNewCallbacksProc MediaNewCallbacks;
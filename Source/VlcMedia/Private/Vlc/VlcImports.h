@@ -44,6 +44,8 @@ typedef int32 (*FLibvlcMediaSeekCb)(void* /*Opaque*/, uint64 /*Offset*/);
 
 // media
 typedef FLibvlcEventManager* (*FLibvlcMediaEventManagerProc)(FLibvlcMedia* /*Media*/);
+typedef const ANSICHAR* (*FLibvlcMediaGetCodecDescriptionProc)(ELibvlcTrackType /*Type*/, uint32 /*Codec*/);
+typedef void (*FLibvlcMediaAddOptionProc)(FLibvlcMedia* /*Media*/, const ANSICHAR* /*Options*/);
 typedef int64 (*FLibvlcMediaGetDurationProc)(FLibvlcMedia* /*Media*/);
 typedef int (*FLibvlcMediaGetStatsProc)(FLibvlcMedia* /*Media*/, FLibvlcMediaStats* /*Stats*/);
 
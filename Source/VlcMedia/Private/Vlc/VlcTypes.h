@@ -130,10 +130,10 @@ enum class ELibvlcState
 /** Enumerates known track types. */
 enum class ELibvlcTrackType
 {
-	Unknown,
-	Audio,
-	Video,
-	Text
+	Unknown = -1,
+	Audio = 0,
+	Video = 1,
+	Text = 2
 };
 
 
@@ -273,6 +273,12 @@ struct FLibvlcEvent
             int32 NewCount;
         } MediaPlayerVout;
 
+		struct
+        {
+            ELibvlcTrackType Type;
+            int32 Id;
+        } MediaPlayerESChanged;
+
         // media list
         struct
         {
@@ -355,6 +361,55 @@ struct FLibvlcMediaStats
 };
 
 
+/**
+ * Structure for VLC video viewpoints (libvlc_video_viewpoint_t).
+ */
+struct FLibvlcVideoViewpoint
+{
+	float Yaw;
+	float Pitch;
+	float Roll;
+	float FieldOfView;
+};
+
+
+/**
+ * Structure for VLC audio track details (libvlc_audio_track_t).
+ */
+struct FLibvlcAudioTrack
+{
+	uint32 Channels;
+	uint32 Rate;
+};
+
+
+/**
+ * Structure for VLC subtitle track details (libvlc_subtitle_track_t).
+ */
+struct FLibvlcSubtitleTrack
+{
+	ANSICHAR* Encoding;
+};
+
+
+/**
+ * Structure for VLC video track details (libvlc_video_track_t).
+ */
+struct FLibvlcVideoTrack
+{
+	uint32 Height;
+	uint32 Width;
+	uint32 SarNum;
+	uint32 SarDen;
+	uint32 FrameRateNum;
+	uint32 FrameRateDen;
+	int32 Orientation;
+	int32 Projection;
+	FLibvlcVideoViewpoint Pose;
+	int32 Multiview;
+};
+
+
 /**
  * Structure for VLC media tracks (libvlc_media_track).
  */
@@ -366,6 +421,17 @@ struct FLibvlcMediaTrack
 	ELibvlcTrackType Type;
 	int32 Profile;
 	int32 Level;
+
+	union
+	{
+		FLibvlcAudioTrack* Audio;
+		FLibvlcVideoTrack* Video;
+		FLibvlcSubtitleTrack* Subtitle;
+	};
+
+	uint32 Bitrate;
+	ANSICHAR* Language;
+	ANSICHAR* Description;
 };
 
 
@@ -379,14 +445,3 @@ struct FLibvlcTrackDescription
 	FLibvlcTrackDescription* Next;
 };
 
-
-/**
- * Structure for VLC video viewpoints (libvlc_video_viewpoint_t).
- */
-struct FLibvlcVideoViewpoint
-{
-	float Yaw;
-	float Pitch;
-	float Roll;
-	float FieldOfView;
-};
@@ -4,6 +4,9 @@
 #include "VlcMediaPrivate.h"
 
 #include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
 #include "Misc/OutputDeviceFile.h"
 #include "Misc/Paths.h"
 #include "Modules/ModuleManager.h"
@@ -12,11 +15,42 @@
 #include "UObject/WeakObjectPtr.h"
 
 #include "Vlc.h"
+#include "VlcMediaBenchmark.h"
 #include "VlcMediaPlayer.h"
+#include "VlcMediaPlayerGroup.h"
+#include "VlcMediaDemuxHints.h"
+#include "VlcMediaProbeIndex.h"
+#include "VlcMediaThumbnailer.h"
 
 
 DEFINE_LOG_CATEGORY(LogVlcMedia);
 
+DEFINE_STAT(STAT_VlcMedia_TickInput);
+DEFINE_STAT(STAT_VlcMedia_AudioPlay);
+DEFINE_STAT(STAT_VlcMedia_AudioSetup);
+DEFINE_STAT(STAT_VlcMedia_VideoDisplay);
+DEFINE_STAT(STAT_VlcMedia_VideoLock);
+DEFINE_STAT(STAT_VlcMedia_VideoSetup);
+DEFINE_STAT(STAT_VlcMedia_VideoUnlock);
+DEFINE_STAT(STAT_VlcMedia_MediaRead);
+DEFINE_STAT(STAT_VlcMedia_MediaSeek);
+
+DEFINE_STAT(STAT_VlcMedia_Players);
+DEFINE_STAT(STAT_VlcMedia_DecodedAudio);
+DEFINE_STAT(STAT_VlcMedia_DecodedVideo);
+DEFINE_STAT(STAT_VlcMedia_DisplayedPictures);
+DEFINE_STAT(STAT_VlcMedia_LostPictures);
+DEFINE_STAT(STAT_VlcMedia_PlayedAudioBuffers);
+DEFINE_STAT(STAT_VlcMedia_LostAudioBuffers);
+DEFINE_STAT(STAT_VlcMedia_InputBitrate);
+DEFINE_STAT(STAT_VlcMedia_DemuxBitrate);
+DEFINE_STAT(STAT_VlcMedia_AudioSampleQueue);
+DEFINE_STAT(STAT_VlcMedia_VideoSampleQueue);
+DEFINE_STAT(STAT_VlcMedia_AudioSamplePool);
+DEFINE_STAT(STAT_VlcMedia_VideoSamplePool);
+
+CSV_DEFINE_CATEGORY(VlcMedia, true);
+
 #define LOCTEXT_NAMESPACE "FVlcMediaModule"
 
 
@@ -30,7 +64,9 @@ public:
 
 	/** Default constructor. */
 	FVlcMediaModule()
-		: Initialized(false)
+		: BenchmarkCommand(nullptr)
+		, DumpTimingsCommand(nullptr)
+		, Initialized(false)
 	{ }
 
 public:
@@ -44,7 +80,62 @@ public:
 			return nullptr;
 		}
 
-		return MakeShared<FVlcMediaPlayer, ESPMode::ThreadSafe>(EventSink, VlcInstance);
+		auto Player = MakeShared<FVlcMediaPlayer, ESPMode::ThreadSafe>(EventSink, VlcInstance, ProbeIndex.Get(), DemuxHints.Get());
+		{
+			Players.RemoveAll([](const TWeakPtr<FVlcMediaPlayer, ESPMode::ThreadSafe>& Weak) { return !Weak.IsValid(); });
+			Players.Add(Player);
+		}
+
+		return Player;
+	}
+
+	virtual TSharedPtr<IVlcMediaPlayerGroup> CreatePlayerGroup() override
+	{
+		if (!Initialized)
+		{
+			return nullptr;
+		}
+
+		return MakeShareable(new FVlcMediaPlayerGroup());
+	}
+
+	virtual bool GetMediaInfo(const FString& FilePath, FVlcMediaInfo& OutInfo) override
+	{
+		if (!Initialized)
+		{
+			return false;
+		}
+
+		if (ProbeIndex->Find(FilePath, OutInfo))
+		{
+			return true;
+		}
+
+		ProbeIndex->Request(FilePath);
+
+		return false;
+	}
+
+	virtual TSharedPtr<IVlcMediaPlayer, ESPMode::ThreadSafe> GetVlcPlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) override
+	{
+		if (Player->GetPlayerName() != FName(TEXT("VlcMedia")))
+		{
+			return nullptr;
+		}
+
+		return StaticCastSharedRef<FVlcMediaPlayer>(Player);
+	}
+
+	virtual bool RequestThumbnail(const FString& Url, FTimespan Time, int32 MaxDim, const FOnVlcMediaThumbnail& Delegate) override
+	{
+		if (!Initialized)
+		{
+			return false;
+		}
+
+		Thumbnailer->Request(Url, Time, MaxDim, Delegate);
+
+		return true;
 	}
 
 public:
@@ -107,6 +198,7 @@ public:
 
 			// performance
 			"--drop-late-frames",
+			"--no-sub-autodetect-file", // players look for subtitle files themselves (see FVlcMediaSubtitles)
 
 			// undesired features
 			"--no-disable-screensaver",
@@ -114,9 +206,8 @@ public:
 			"--no-snapshot-preview",
 			"--no-video-title-show",
 
-#if (UE_BUILD_SHIPPING || UE_BUILD_TEST)
-			"--no-stats",
-#endif
+			// statistics
+			Settings->CollectStats ? "--stats" : "--no-stats",
 
 #if PLATFORM_LINUX
 			"--no-xlib",
@@ -137,6 +228,33 @@ public:
 		// register logging callback
 		FVlc::LogSet(VlcInstance, &FVlcMediaModule::HandleVlcLog, nullptr);
 
+		// load media probe index
+		ProbeIndex = MakeUnique<FVlcMediaProbeIndex>(VlcInstance);
+		ProbeIndex->Load();
+
+		// load demuxer probe order
+		DemuxHints = MakeUnique<FVlcMediaDemuxHints>();
+		DemuxHints->Load();
+
+		Thumbnailer = MakeUnique<FVlcMediaThumbnailer>(VlcInstance);
+
+		// register console commands
+		BenchmarkCommand = IConsoleManager::Get().RegisterConsoleCommand(
+			TEXT("VlcMedia.Benchmark"),
+			TEXT("Measure the decoding throughput for a list of media files without rendering.\n")
+			TEXT("Usage: VlcMedia.Benchmark <File|Directory>... [-rate=<Rate>] [-report=<FilePath>] [-compareaccess] [-exit]"),
+			FConsoleCommandWithArgsDelegate::CreateRaw(this, &FVlcMediaModule::HandleBenchmarkCommand),
+			ECVF_Default
+		);
+
+		DumpTimingsCommand = IConsoleManager::Get().RegisterConsoleCommand(
+			TEXT("VlcMedia.DumpTimings"),
+			TEXT("Write the callback timings of all VLC media players to a CSV file.\n")
+			TEXT("Usage: VlcMedia.DumpTimings [FilePath]"),
+			FConsoleCommandWithArgsDelegate::CreateRaw(this, &FVlcMediaModule::HandleDumpTimingsCommand),
+			ECVF_Default
+		);
+
 		Initialized = true;
 	}
 
@@ -149,6 +267,32 @@ public:
 
 		Initialized = false;
 
+		// unregister console commands
+		if (BenchmarkCommand != nullptr)
+		{
+			IConsoleManager::Get().UnregisterConsoleObject(BenchmarkCommand);
+			BenchmarkCommand = nullptr;
+		}
+
+		Benchmark.Reset();
+
+		if (DumpTimingsCommand != nullptr)
+		{
+			IConsoleManager::Get().UnregisterConsoleObject(DumpTimingsCommand);
+			DumpTimingsCommand = nullptr;
+		}
+
+		Players.Empty();
+		Thumbnailer.Reset();
+
+		// save media probe index
+		ProbeIndex->Save();
+		ProbeIndex.Reset();
+
+		// save demuxer probe order
+		DemuxHints->Save();
+		DemuxHints.Reset();
+
 		// unregister logging callback
 		FVlc::LogUnset(VlcInstance);
 
@@ -162,6 +306,63 @@ public:
 
 private:
 
+	/** Handles the VlcMedia.Benchmark console command. */
+	void HandleBenchmarkCommand(const TArray<FString>& Args)
+	{
+		if (Benchmark.IsValid() && !Benchmark->IsDone())
+		{
+			UE_LOG(LogVlcMedia, Warning, TEXT("A benchmark is already running."));
+			return;
+		}
+
+		TArray<FString> Files;
+		float Rate = 32.0f;
+		FString ReportPath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("VlcMedia"), FString::Printf(TEXT("Benchmark-%s.csv"), *FDateTime::Now().ToString()));
+		bool ExitWhenDone = false;
+		bool CompareAccess = false;
+
+		FVlcMediaBenchmark::ParseArgs(Args, Files, Rate, ReportPath, ExitWhenDone, CompareAccess);
+
+		if (Files.Num() == 0)
+		{
+			UE_LOG(LogVlcMedia, Warning, TEXT("No media files specified for benchmark."));
+			return;
+		}
+
+		Benchmark = MakeShareable(new FVlcMediaBenchmark(VlcInstance, Files, Rate, ReportPath, ExitWhenDone, CompareAccess));
+		Benchmark->Start();
+	}
+
+	/** Handles the VlcMedia.DumpTimings console command. */
+	void HandleDumpTimingsCommand(const TArray<FString>& Args)
+	{
+		const FString FilePath = (Args.Num() > 0)
+			? Args[0]
+			: FPaths::Combine(FPaths::ProfilingDir(), TEXT("VlcMedia"), FString::Printf(TEXT("Timings-%s.csv"), *FDateTime::Now().ToString()));
+
+		TArray<FString> Rows;
+		Rows.Add(FString(TEXT("Url,Callback,")) + FVlcMediaHistogram::GetCsvHeader());
+
+		for (const auto& Weak : Players)
+		{
+			TSharedPtr<FVlcMediaPlayer, ESPMode::ThreadSafe> Player = Weak.Pin();
+
+			if (Player.IsValid())
+			{
+				Player->GetTimingRows(Rows);
+			}
+		}
+
+		if (FFileHelper::SaveStringArrayToFile(Rows, *FilePath))
+		{
+			UE_LOG(LogVlcMedia, Log, TEXT("Wrote %i timing rows to %s"), Rows.Num() - 1, *FilePath);
+		}
+		else
+		{
+			UE_LOG(LogVlcMedia, Warning, TEXT("Failed to write timings to %s"), *FilePath);
+		}
+	}
+
 	/** Handles log messages from LibVLC. */
 	static void HandleVlcLog(void* /*Data*/, ELibvlcLogLevel Level, FLibvlcLog* Context, const char* Format, va_list Args)
 	{
@@ -231,9 +432,30 @@ private:
 
 private:
 
+	/** The currently running or last completed benchmark. */
+	TSharedPtr<FVlcMediaBenchmark> Benchmark;
+
+	/** The VlcMedia.Benchmark console command. */
+	IConsoleObject* BenchmarkCommand;
+
+	/** Demuxer probe order for media streamed from archives. */
+	TUniquePtr<FVlcMediaDemuxHints> DemuxHints;
+
+	/** The VlcMedia.DumpTimings console command. */
+	IConsoleObject* DumpTimingsCommand;
+
 	/** Whether the module has been initialized. */
 	bool Initialized;
 
+	/** Index of previously probed media files. */
+	TUniquePtr<FVlcMediaProbeIndex> ProbeIndex;
+
+	/** Media players created by this module. */
+	TArray<TWeakPtr<FVlcMediaPlayer, ESPMode::ThreadSafe>> Players;
+
+	/** Extracts thumbnails in the background. */
+	TUniquePtr<FVlcMediaThumbnailer> Thumbnailer;
+
 	/** The LibVLC instance. */
 	FLibvlcInstance* VlcInstance;
 };
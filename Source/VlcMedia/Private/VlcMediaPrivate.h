@@ -3,9 +3,43 @@
 #pragma once
 
 #include "Logging/LogMacros.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
 
 #include "../../VlcMediaFactory/Public/VlcMediaSettings.h"
 
 
 /** Declares a log category for this module. */
 DECLARE_LOG_CATEGORY_EXTERN(LogVlcMedia, Log, All);
+
+
+/** Declares a stat group for this module. */
+DECLARE_STATS_GROUP(TEXT("VlcMedia"), STATGROUP_VlcMedia, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Input"), STAT_VlcMedia_TickInput, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Audio Play Callback"), STAT_VlcMedia_AudioPlay, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Audio Setup Callback"), STAT_VlcMedia_AudioSetup, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Video Display Callback"), STAT_VlcMedia_VideoDisplay, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Video Lock Callback"), STAT_VlcMedia_VideoLock, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Video Setup Callback"), STAT_VlcMedia_VideoSetup, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Video Unlock Callback"), STAT_VlcMedia_VideoUnlock, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Media Read Callback"), STAT_VlcMedia_MediaRead, STATGROUP_VlcMedia, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Media Seek Callback"), STAT_VlcMedia_MediaSeek, STATGROUP_VlcMedia, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Players"), STAT_VlcMedia_Players, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Decoded Audio Blocks"), STAT_VlcMedia_DecodedAudio, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Decoded Video Frames"), STAT_VlcMedia_DecodedVideo, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Displayed Pictures"), STAT_VlcMedia_DisplayedPictures, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Lost Pictures"), STAT_VlcMedia_LostPictures, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Played Audio Buffers"), STAT_VlcMedia_PlayedAudioBuffers, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Lost Audio Buffers"), STAT_VlcMedia_LostAudioBuffers, STATGROUP_VlcMedia, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Input Bitrate (kbit/s)"), STAT_VlcMedia_InputBitrate, STATGROUP_VlcMedia, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Demux Bitrate (kbit/s)"), STAT_VlcMedia_DemuxBitrate, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Audio Sample Queue"), STAT_VlcMedia_AudioSampleQueue, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Video Sample Queue"), STAT_VlcMedia_VideoSampleQueue, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Audio Sample Pool"), STAT_VlcMedia_AudioSamplePool, STATGROUP_VlcMedia, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Video Sample Pool"), STAT_VlcMedia_VideoSamplePool, STATGROUP_VlcMedia, );
+
+
+/** Declares a CSV profiler category for this module. */
+CSV_DECLARE_CATEGORY_EXTERN(VlcMedia);
@@ -4,9 +4,14 @@
 
 #include "Modules/ModuleInterface.h"
 #include "Templates/SharedPointer.h"
+#include "VlcMediaThumbnail.h"
 
 class IMediaEventSink;
 class IMediaPlayer;
+class IVlcMediaPlayer;
+class IVlcMediaPlayerGroup;
+
+struct FVlcMediaInfo;
 
 
 /**
@@ -25,6 +30,50 @@ public:
 	 */
 	virtual TSharedPtr<IMediaPlayer, ESPMode::ThreadSafe> CreatePlayer(IMediaEventSink& EventSink) = 0;
 
+	/**
+	 * Create a group of media players that play in sync.
+	 *
+	 * @return A new player group, or nullptr if the module isn't initialized.
+	 * @see CreatePlayer
+	 */
+	virtual TSharedPtr<IVlcMediaPlayerGroup> CreatePlayerGroup() = 0;
+
+	/**
+	 * Get information about a media file without opening it in a player.
+	 *
+	 * Files that have not been opened or probed before are probed in the
+	 * background, so their information will be available in a later call.
+	 *
+	 * @param FilePath Path to the media file.
+	 * @param OutInfo Will contain the media information.
+	 * @return true if the information is available, false otherwise.
+	 */
+	virtual bool GetMediaInfo(const FString& FilePath, FVlcMediaInfo& OutInfo) = 0;
+
+	/**
+	 * Get the VideoLAN specific interface of a media player.
+	 *
+	 * @param Player The player to get the interface for.
+	 * @return The interface, or nullptr if the player wasn't created by this module.
+	 * @see CreatePlayer
+	 */
+	virtual TSharedPtr<IVlcMediaPlayer, ESPMode::ThreadSafe> GetVlcPlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) = 0;
+
+	/**
+	 * Extract a thumbnail image from a media source in the background.
+	 *
+	 * Thumbnails are extracted by a small pool of players without audio, so
+	 * this is much cheaper than opening a media player per media source.
+	 * Results are cached by URL, time and size.
+	 *
+	 * @param Url The URL of the media source.
+	 * @param Time The time of the frame to extract (the nearest key frame is used).
+	 * @param MaxDim The maximum width or height of the thumbnail (0 = source size).
+	 * @param Delegate The delegate to execute on the game thread when the thumbnail is available.
+	 * @return true if the request was queued, false if the module isn't initialized.
+	 */
+	virtual bool RequestThumbnail(const FString& Url, FTimespan Time, int32 MaxDim, const FOnVlcMediaThumbnail& Delegate) = 0;
+
 public:
 
 	/** Virtual destructor. */
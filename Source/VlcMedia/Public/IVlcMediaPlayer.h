@@ -0,0 +1,138 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/**
+ * Interface for VideoLAN specific features of VlcMedia players.
+ *
+ * Use IVlcMediaModule::GetVlcPlayer to access this interface on a player
+ * that was created by the VlcMedia module.
+ */
+class IVlcMediaPlayer
+{
+public:
+
+	/**
+	 * Get the maximum rate at which video frames are delivered.
+	 *
+	 * @return Frames per second (zero = no limit).
+	 * @see SetDeliveryRate
+	 */
+	virtual float GetDeliveryRate() const = 0;
+
+	/**
+	 * Check whether audio is decoded.
+	 *
+	 * @return true if audio is decoded, false otherwise.
+	 * @see IsDecodingVideo, SetDecodeStreams
+	 */
+	virtual bool IsDecodingAudio() const = 0;
+
+	/**
+	 * Check whether video is decoded.
+	 *
+	 * @return true if video is decoded, false otherwise.
+	 * @see IsDecodingAudio, SetDecodeStreams
+	 */
+	virtual bool IsDecodingVideo() const = 0;
+
+	/**
+	 * Check whether the player is recording the media it plays.
+	 *
+	 * @return true if recording, false otherwise.
+	 * @see StartRecording, StopRecording
+	 */
+	virtual bool IsRecording() const = 0;
+
+	/**
+	 * Check whether a frame step is still waiting for its target frame.
+	 *
+	 * @return true if the frame is being decoded, false otherwise.
+	 * @see StepFrames
+	 */
+	virtual bool IsStepPending() const = 0;
+
+	/**
+	 * Choose which kinds of streams are decoded.
+	 *
+	 * Disabled streams are not decoded at all, i.e. for music streams that
+	 * carry a video track, or for muted video tiles. Changing the streams of
+	 * an open media restarts it at the current time. The initial streams can
+	 * be set with the DecodeAudio and DecodeVideo media options.
+	 *
+	 * @param Audio Whether to decode audio.
+	 * @param Video Whether to decode video.
+	 * @return true on success, false otherwise.
+	 * @see IsDecodingAudio, IsDecodingVideo
+	 */
+	virtual bool SetDecodeStreams(bool Audio, bool Video) = 0;
+
+	/**
+	 * Limit the rate at which video frames are delivered, i.e. for previews.
+	 *
+	 * Frames between the chosen cadence are dropped before they are copied
+	 * into video samples. At low rates, the decoder also skips B-frames,
+	 * which saves decoding work. Switching decoder skipping on or off
+	 * restarts the media at the current time.
+	 *
+	 * The initial rate can be set with the DeliveryRate media option.
+	 *
+	 * @param FramesPerSecond The maximum rate (zero = deliver all frames).
+	 * @return true on success, false otherwise.
+	 * @see GetDeliveryRate
+	 */
+	virtual bool SetDeliveryRate(float FramesPerSecond) = 0;
+
+	/**
+	 * Start recording the currently playing media to a file.
+	 *
+	 * The demuxed streams are remuxed into the file as they are played, so
+	 * the media is not decoded a second time. The container is chosen by the
+	 * file extension (.mkv, .mp4, .ogg, or MPEG-TS for all others).
+	 *
+	 * Starting a recording restarts the media at the current playback time,
+	 * which may cause a short hitch. Other changes that restart the media
+	 * while recording, such as switching decoded streams or thinned playback
+	 * rates, continue the recording in a new file whose name has a running
+	 * number appended (i.e. Recording_1.mp4, Recording_2.mp4, ...).
+	 *
+	 * @param FilePath Path of the file to record to (will be overwritten).
+	 * @return true if recording started, false otherwise.
+	 * @see IsRecording, StopRecording
+	 */
+	virtual bool StartRecording(const FString& FilePath) = 0;
+
+	/**
+	 * Pause playback and step forward or backward by a number of video frames.
+	 *
+	 * Decoded frames around the current position are cached, so steps within
+	 * the cache are delivered on the next tick. Other steps decode forward
+	 * from the preceding key frame in the background (see IsStepPending).
+	 * Frame times are counted from the key frame, so streams with variable
+	 * frame rates may land a frame off. The cache may also deliver frames at
+	 * a lower resolution (see UVlcMediaSettings::ReverseCacheSize).
+	 * The player sends EMediaEvent::SeekCompleted once the target frame was
+	 * delivered. Calling Play or SetRate with a positive rate continues
+	 * normal playback from the stepped position.
+	 *
+	 * @param NumFrames Number of frames to step (negative = backward).
+	 * @return true if the step was started, false if not supported for the current media.
+	 * @see IsStepPending
+	 */
+	virtual bool StepFrames(int32 NumFrames) = 0;
+
+	/**
+	 * Stop recording and finalize the recorded file.
+	 *
+	 * @see IsRecording, StartRecording
+	 */
+	virtual void StopRecording() = 0;
+
+public:
+
+	/** Virtual destructor. */
+	virtual ~IVlcMediaPlayer() { }
+};
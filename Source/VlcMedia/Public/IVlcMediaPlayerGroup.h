@@ -0,0 +1,84 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+
+class IMediaPlayer;
+
+
+/**
+ * Interface for groups of VideoLAN based media players that play in sync.
+ *
+ * All members of a group are driven by a shared master clock. The group
+ * periodically measures how far each member's decoder drifted from the
+ * master clock and corrects it with small playback rate adjustments, or by
+ * seeking if the member is too far off.
+ */
+class IVlcMediaPlayerGroup
+{
+public:
+
+	/**
+	 * Add a player to the group.
+	 *
+	 * @param Player The player to add (must have been created by the VlcMedia module).
+	 * @return true if the player was added, false otherwise.
+	 * @see RemovePlayer
+	 */
+	virtual bool AddPlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) = 0;
+
+	/**
+	 * Get the last measured synchronization error of a group member.
+	 *
+	 * @param Player The player to get the error for.
+	 * @return The decoder time minus the master time.
+	 */
+	virtual FTimespan GetSyncError(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) const = 0;
+
+	/**
+	 * Get the time of the master clock.
+	 *
+	 * @return Master time.
+	 */
+	virtual FTimespan GetTime() const = 0;
+
+	/**
+	 * Pause all players in the group.
+	 *
+	 * @return true on success, false otherwise.
+	 * @see Play
+	 */
+	virtual bool Pause() = 0;
+
+	/**
+	 * Start or resume playback of all players in the group.
+	 *
+	 * @param Rate The playback rate.
+	 * @return true on success, false otherwise.
+	 * @see Pause
+	 */
+	virtual bool Play(float Rate = 1.0f) = 0;
+
+	/**
+	 * Remove a player from the group.
+	 *
+	 * @param Player The player to remove.
+	 * @see AddPlayer
+	 */
+	virtual void RemovePlayer(const TSharedRef<IMediaPlayer, ESPMode::ThreadSafe>& Player) = 0;
+
+	/**
+	 * Seek all players in the group.
+	 *
+	 * @param Time The time to seek to.
+	 * @return true on success, false otherwise.
+	 */
+	virtual bool Seek(const FTimespan& Time) = 0;
+
+public:
+
+	/** Virtual destructor. */
+	virtual ~IVlcMediaPlayerGroup() { }
+};
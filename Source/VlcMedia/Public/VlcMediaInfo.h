@@ -0,0 +1,110 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+
+
+/**
+ * Information about a media track.
+ */
+struct FVlcMediaTrackInfo
+{
+	/** Average bit rate (in bits per second, or 0 if unknown). */
+	uint32 BitRate;
+
+	/** Video dimensions (video tracks only). */
+	FIntPoint Dim;
+
+	/** Video frame rate (video tracks only). */
+	float FrameRate;
+
+	/** VLC's elementary stream identifier. */
+	int32 Id;
+
+	/** Average time between key frames (video tracks only, zero if unknown). */
+	FTimespan KeyframeInterval;
+
+	/** ISO 639 language code (empty if unknown). */
+	FString Language;
+
+	/** Track name. */
+	FString Name;
+
+	/** Number of audio channels (audio tracks only). */
+	uint32 NumChannels;
+
+	/** Audio sample rate (audio tracks only). */
+	uint32 SampleRate;
+
+	/** Codec name. */
+	FString TypeName;
+
+public:
+
+	/** Default constructor. */
+	FVlcMediaTrackInfo()
+		: BitRate(0)
+		, Dim(FIntPoint::ZeroValue)
+		, FrameRate(0.0f)
+		, Id(-1)
+		, KeyframeInterval(FTimespan::Zero())
+		, NumChannels(0)
+		, SampleRate(0)
+	{ }
+
+public:
+
+	/**
+	 * Serialize track information from or into an archive.
+	 *
+	 * @param Ar The archive to serialize from or into.
+	 * @param Info The track information to serialize.
+	 * @return The archive.
+	 */
+	friend FArchive& operator<<(FArchive& Ar, FVlcMediaTrackInfo& Info)
+	{
+		return Ar << Info.BitRate << Info.Dim << Info.FrameRate << Info.Id << Info.KeyframeInterval << Info.Language << Info.Name << Info.NumChannels << Info.SampleRate << Info.TypeName;
+	}
+};
+
+
+/**
+ * Information about a media file, as determined by probing it with VLC.
+ */
+struct FVlcMediaInfo
+{
+	/** Audio tracks. */
+	TArray<FVlcMediaTrackInfo> AudioTracks;
+
+	/** Caption tracks. */
+	TArray<FVlcMediaTrackInfo> CaptionTracks;
+
+	/** Media duration. */
+	FTimespan Duration;
+
+	/** Video tracks. */
+	TArray<FVlcMediaTrackInfo> VideoTracks;
+
+public:
+
+	/** Default constructor. */
+	FVlcMediaInfo()
+		: Duration(FTimespan::Zero())
+	{ }
+
+public:
+
+	/**
+	 * Serialize media information from or into an archive.
+	 *
+	 * @param Ar The archive to serialize from or into.
+	 * @param Info The media information to serialize.
+	 * @return The archive.
+	 */
+	friend FArchive& operator<<(FArchive& Ar, FVlcMediaInfo& Info)
+	{
+		return Ar << Info.AudioTracks << Info.CaptionTracks << Info.Duration << Info.VideoTracks;
+	}
+};
@@ -0,0 +1,30 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+
+
+/**
+ * A thumbnail image extracted from a media source.
+ */
+struct FVlcMediaThumbnail
+{
+	/** The pixels (8-bit BGRA, rows are tightly packed). */
+	TArray<uint8> Buffer;
+
+	/** Width and height of the image. */
+	FIntPoint Dim;
+
+	/** Time of the extracted frame (the key frame nearest to the requested time). */
+	FTimespan Time;
+};
+
+
+/**
+ * Delegate that is executed on the game thread when a thumbnail request completed.
+ *
+ * The thumbnail is invalid if it couldn't be extracted.
+ */
+DECLARE_DELEGATE_OneParam(FOnVlcMediaThumbnail, TSharedPtr<const FVlcMediaThumbnail, ESPMode::ThreadSafe> /*Thumbnail*/);
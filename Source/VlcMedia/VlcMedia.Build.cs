@@ -35,6 +35,7 @@ namespace UnrealBuildTool.Rules
 			PrivateIncludePaths.AddRange(
 				new string[] {
 					"VlcMedia/Private",
+					"VlcMedia/Private/Benchmark",
 					"VlcMedia/Private/Player",
 					"VlcMedia/Private/Shared",
 					"VlcMedia/Private/Vlc",
@@ -292,6 +292,7 @@ public:
 		SupportedUriSchemes.Add(TEXT("sap"));
 		SupportedUriSchemes.Add(TEXT("smb"));
 		SupportedUriSchemes.Add(TEXT("screen"));
+		SupportedUriSchemes.Add(TEXT("udp"));
 		SupportedUriSchemes.Add(TEXT("unsv"));
 		SupportedUriSchemes.Add(TEXT("v4l2"));
 		SupportedUriSchemes.Add(TEXT("vcd"));
@@ -8,6 +8,14 @@ UVlcMediaSettings::UVlcMediaSettings()
 	, FileCaching(FTimespan::FromMilliseconds(300.0))
 	, LiveCaching(FTimespan::FromMilliseconds(300.0))
 	, NetworkCaching(FTimespan::FromMilliseconds(1000.0))
+	, LowLatencyLive(false)
+	, LowLatencyCaching(FTimespan::FromMilliseconds(50.0))
+	, TimeshiftLive(false)
+	, TimeshiftWindow(FTimespan::FromMinutes(10.0))
 	, LogLevel(EVlcMediaLogLevel::Warning)
 	, ShowLogContext(false)
+	, CollectStats(!UE_BUILD_SHIPPING)
+	, IndexKeyframes(true)
+	, NativeFileAccess(true)
+	, ReverseCacheSize(256)
 { }
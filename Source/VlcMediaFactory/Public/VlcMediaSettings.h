@@ -58,6 +58,36 @@ public:
 	UPROPERTY(config, EditAnywhere, Category=Caching)
 	FTimespan NetworkCaching;
 
+public:
+
+	/**
+	 * Whether to play RTSP, RTP and UDP streams with minimal latency (default = false).
+	 *
+	 * Low-latency streams use the caching duration below, don't synchronize
+	 * to the sender's clock, and always present the newest decoded frame.
+	 * This can be overridden per media source with the 'LowLatency' media option.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Live)
+	bool LowLatencyLive;
+
+	/** Caching duration for low-latency live streams (default = 50 ms). */
+	UPROPERTY(config, EditAnywhere, Category=Live)
+	FTimespan LowLatencyCaching;
+
+	/**
+	 * Whether to record live streams into a time-shift buffer, so they can be paused and rewound (default = false).
+	 *
+	 * Applies to RTMP, RTP, RTSP, UDP and MMS streams. The buffer is kept
+	 * in the project's Saved/VlcMedia directory while the stream is open.
+	 * This can be overridden per media source with the 'Timeshift' media option.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Live)
+	bool TimeshiftLive;
+
+	/** Maximum duration of the time-shift buffer (default = 10 minutes). */
+	UPROPERTY(config, EditAnywhere, Category=Live)
+	FTimespan TimeshiftWindow;
+
 public:
 
 	/**
@@ -72,4 +102,51 @@ public:
 	/** Whether to include file name & line number in LibVLC log messages. */
 	UPROPERTY(config, EditAnywhere, Category=Debugging)
 	bool ShowLogContext;
+
+public:
+
+	/**
+	 * Whether LibVLC should collect decoder, input and demuxer statistics (default = true, except in Shipping builds).
+	 *
+	 * The statistics are shown in the VlcMedia stat group ('stat VlcMedia').
+	 * Changing this setting requires an application restart.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Performance)
+	bool CollectStats;
+
+	/**
+	 * Whether to index the key frames of local MPEG transport stream files for faster seeking (default = true).
+	 *
+	 * Each file is scanned once in the background, and the index is cached
+	 * in the project's Saved/VlcMedia directory. Seeks during playback jump to
+	 * the preceding key frame and quickly decode the frames up to the requested
+	 * time without delivering them. Seeks while paused are left to VLC.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Performance)
+	bool IndexKeyframes;
+
+	/**
+	 * Whether VLC should read local files directly from disk (default = true).
+	 *
+	 * Otherwise all local files are streamed to VLC through the engine's file
+	 * manager. Files that are not physically on disk, such as files in pak
+	 * files, are always streamed. This can be overridden per media source
+	 * with the 'NativeFileAccess' media option.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Performance)
+	bool NativeFileAccess;
+
+	/**
+	 * Maximum memory per player for decoded frames during reverse playback, in megabytes (default = 256).
+	 *
+	 * Reverse playback decodes each group of pictures forward and keeps its
+	 * frames until they were played. Larger caches make it cheaper to change
+	 * direction or scrub within recently played video. Frames are decoded at
+	 * a lower resolution if two GOPs of average length don't fit, i.e. video
+	 * with two second GOPs at 30 fps plays in reverse at about 960x540 with
+	 * the default size. Longer than average GOPs keep only their most recent
+	 * frames, and frame steps past those decode the GOP again.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Performance, meta=(ClampMin=16, UIMin=16))
+	int32 ReverseCacheSize;
 };